@@ -0,0 +1,129 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDALLOCATIONTRACKER_H__
+#define __PMDALLOCATIONTRACKER_H__
+
+#include <cstddef>
+
+#include "PMDocument.h"
+
+namespace libpagemaker
+{
+
+/**
+  Phases of PMDocument::parse() that allocations are attributed to.
+*/
+enum PMDAllocationPhase
+{
+  /// Outside of the phases below, e.g., document start and end
+  PMD_ALLOCATION_PHASE_OTHER,
+  /// Reading and decoding the document
+  PMD_ALLOCATION_PHASE_PARSE,
+  /// Computing the output geometry of the shapes
+  PMD_ALLOCATION_PHASE_LAYOUT,
+  /// Passing the shapes to the painter, including the painter's own allocations
+  PMD_ALLOCATION_PHASE_PAINT,
+
+  PMD_ALLOCATION_PHASE_COUNT
+};
+
+/**
+  Kinds of shapes that allocations are attributed to.
+*/
+enum PMDAllocationShape
+{
+  /// Not specific to a shape
+  PMD_ALLOCATION_SHAPE_NONE,
+  PMD_ALLOCATION_SHAPE_LINE,
+  PMD_ALLOCATION_SHAPE_RECTANGLE,
+  PMD_ALLOCATION_SHAPE_POLYGON,
+  PMD_ALLOCATION_SHAPE_ELLIPSE,
+  PMD_ALLOCATION_SHAPE_TEXT,
+  PMD_ALLOCATION_SHAPE_BITMAP,
+
+  PMD_ALLOCATION_SHAPE_COUNT
+};
+
+/**
+  Allocations attributed to a phase or a shape kind.
+*/
+struct PMDAllocationCounts
+{
+  /// Number of allocations.
+  unsigned long m_allocations;
+  /// Total size of the allocations, in bytes.
+  unsigned long m_bytes;
+  /// Highest number of bytes allocated and not yet freed at any time.
+  unsigned long m_peakBytes;
+
+  PMDAllocationCounts()
+    : m_allocations(0), m_bytes(0), m_peakBytes(0)
+  { }
+};
+
+/**
+  Allocations made while PMDAllocationTracker was running.
+*/
+struct PMDAllocationStats
+{
+  PMDAllocationCounts m_total;
+  PMDAllocationCounts m_phases[PMD_ALLOCATION_PHASE_COUNT];
+  PMDAllocationCounts m_shapes[PMD_ALLOCATION_SHAPE_COUNT];
+
+  PMDAllocationStats()
+    : m_total(), m_phases(), m_shapes()
+  { }
+};
+
+/**
+  Attributes memory allocations to the phases of parsing and to shape
+  kinds.
+
+  The library cannot see allocations by itself. An application that
+  wants the numbers replaces the global operator new and operator
+  delete, calls allocated() for every allocation and keeps the
+  returned tag with it, and passes the tag to deallocated() when the
+  memory is freed. These two functions do not allocate and may be
+  called from any thread.
+
+  Allocations are only counted between start() and stop().
+*/
+class PMDAllocationTracker
+{
+public:
+  /// Clears the counts and starts counting.
+  static PAGEMAKERAPI void start();
+  /// Stops counting.
+  static PAGEMAKERAPI void stop();
+  /// Returns the counts collected since the last start().
+  static PAGEMAKERAPI void getStats(PMDAllocationStats &stats);
+
+  /**
+    Records an allocation.
+
+    \param size The size of the allocation
+    \return A tag to pass to deallocated() for this allocation
+  */
+  static PAGEMAKERAPI unsigned allocated(std::size_t size);
+
+  /**
+    Records the freeing of an allocation.
+
+    \param tag The tag returned by allocated()
+    \param size The size of the allocation
+  */
+  static PAGEMAKERAPI void deallocated(unsigned tag, std::size_t size);
+};
+
+} // namespace libpagemaker
+
+#endif // __PMDALLOCATIONTRACKER_H__
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,51 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDIMAGESINK_H__
+#define __PMDIMAGESINK_H__
+
+#include <librevenge/librevenge.h>
+
+namespace libpagemaker
+{
+
+/**
+  Receiver for the images of a document.
+
+  If an image sink is passed to PMDocument::parse(), the image data are
+  not embedded into the drawGraphicObject() calls of the painter.
+  Instead, every image is handed to the sink, which stores it somewhere
+  (e.g., in a file) and returns a reference to it. The painter then
+  gets the reference as "xlink:href" in place of "office:binary-data".
+
+  Identical images are only stored once; all their occurrences get the
+  same reference.
+*/
+class PMDImageSink
+{
+public:
+  virtual ~PMDImageSink()
+  {
+  }
+
+  /**
+    Stores an image.
+
+    \param data The image data
+    \param mimeType The MIME type of the image data
+    \return A reference to the stored image, e.g., a file name or URL
+  */
+  virtual librevenge::RVNGString storeImage(const librevenge::RVNGBinaryData &data, const librevenge::RVNGString &mimeType) = 0;
+};
+
+} // namespace libpagemaker
+
+#endif // __PMDIMAGESINK_H__
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,130 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDPARSESTATS_H__
+#define __PMDPARSESTATS_H__
+
+namespace libpagemaker
+{
+
+/**
+  Phases of parsing and output that are timed by PMDParseStats.
+*/
+enum PMDStatsPhase
+{
+  PMD_PHASE_HEADER,
+  PMD_PHASE_TOC,
+  PMD_PHASE_FONTS,
+  PMD_PHASE_COLORS,
+  PMD_PHASE_XFORMS,
+  PMD_PHASE_TEXT_BLOCKS,
+  PMD_PHASE_PARSE_LINE,
+  PMD_PHASE_PARSE_RECTANGLE,
+  PMD_PHASE_PARSE_POLYGON,
+  PMD_PHASE_PARSE_ELLIPSE,
+  PMD_PHASE_PARSE_TEXT,
+  PMD_PHASE_PARSE_BITMAP,
+  PMD_PHASE_OUTPUT_SHAPES,
+  PMD_PHASE_PAINT_LINE,
+  PMD_PHASE_PAINT_RECTANGLE,
+  PMD_PHASE_PAINT_POLYGON,
+  PMD_PHASE_PAINT_ELLIPSE,
+  PMD_PHASE_PAINT_TEXT,
+  PMD_PHASE_PAINT_BITMAP,
+
+  PMD_PHASE_COUNT
+};
+
+/**
+  Accumulated time spent in one phase.
+*/
+struct PMDPhaseStats
+{
+  /// Number of times the phase was entered, e.g., the number of shapes.
+  unsigned long m_count;
+  /**
+    Time spent in the phase, in seconds. Phases that run on several
+    threads report the sum over all threads.
+  */
+  double m_seconds;
+
+  PMDPhaseStats()
+    : m_count(0), m_seconds(0)
+  { }
+};
+
+/**
+  Timing statistics of a PMDocument::parse() call.
+
+  They are only collected if the library was configured with
+  --enable-stats; otherwise m_available stays false and all phases are
+  empty.
+*/
+struct PMDParseStats
+{
+  bool m_available;
+  PMDPhaseStats m_phases[PMD_PHASE_COUNT];
+
+  PMDParseStats()
+    : m_available(false), m_phases()
+  { }
+
+  static const char *getPhaseName(const PMDStatsPhase phase)
+  {
+    switch (phase)
+    {
+    case PMD_PHASE_HEADER:
+      return "header";
+    case PMD_PHASE_TOC:
+      return "table of contents";
+    case PMD_PHASE_FONTS:
+      return "fonts";
+    case PMD_PHASE_COLORS:
+      return "colors";
+    case PMD_PHASE_XFORMS:
+      return "transformations";
+    case PMD_PHASE_TEXT_BLOCKS:
+      return "text blocks";
+    case PMD_PHASE_PARSE_LINE:
+      return "parse line";
+    case PMD_PHASE_PARSE_RECTANGLE:
+      return "parse rectangle";
+    case PMD_PHASE_PARSE_POLYGON:
+      return "parse polygon";
+    case PMD_PHASE_PARSE_ELLIPSE:
+      return "parse ellipse";
+    case PMD_PHASE_PARSE_TEXT:
+      return "parse text box";
+    case PMD_PHASE_PARSE_BITMAP:
+      return "parse bitmap";
+    case PMD_PHASE_OUTPUT_SHAPES:
+      return "output shapes";
+    case PMD_PHASE_PAINT_LINE:
+      return "paint line";
+    case PMD_PHASE_PAINT_RECTANGLE:
+      return "paint rectangle";
+    case PMD_PHASE_PAINT_POLYGON:
+      return "paint polygon";
+    case PMD_PHASE_PAINT_ELLIPSE:
+      return "paint ellipse";
+    case PMD_PHASE_PAINT_TEXT:
+      return "paint text box";
+    case PMD_PHASE_PAINT_BITMAP:
+      return "paint bitmap";
+    default:
+      return "unknown";
+    }
+  }
+};
+
+} // namespace libpagemaker
+
+#endif // __PMDPARSESTATS_H__
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
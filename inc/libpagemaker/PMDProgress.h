@@ -0,0 +1,77 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDPROGRESS_H__
+#define __PMDPROGRESS_H__
+
+namespace libpagemaker
+{
+
+/**
+  Receiver of the progress of PMDocument::parse().
+
+  Every function may cancel the parsing by returning false; parse()
+  then fails with PMD_ERROR_CANCELLED. Pages are decoded by the threads
+  of PMDParseOptions::m_threads, so the functions may be called from
+  any of them, but never concurrently.
+
+  The page counts only include the pages that are decoded and painted,
+  i.e., those in the requested page range.
+*/
+class PMDProgress
+{
+public:
+  virtual ~PMDProgress()
+  {
+  }
+
+  /**
+    Called when the table of contents of the document has been read.
+
+    \return false to cancel the parsing
+  */
+  virtual bool tableOfContentsRead()
+  {
+    return true;
+  }
+
+  /**
+    Called when the shapes of a page have been decoded.
+
+    \param decoded The number of pages decoded so far
+    \param total The number of pages to decode
+    \return false to cancel the parsing
+  */
+  virtual bool pageDecoded(unsigned decoded, unsigned total)
+  {
+    (void) decoded;
+    (void) total;
+    return true;
+  }
+
+  /**
+    Called when a page has been passed to the painter.
+
+    \param painted The number of pages painted so far
+    \param total The number of pages to paint
+    \return false to cancel the parsing
+  */
+  virtual bool pagePainted(unsigned painted, unsigned total)
+  {
+    (void) painted;
+    (void) total;
+    return true;
+  }
+};
+
+} // namespace libpagemaker
+
+#endif // __PMDPROGRESS_H__
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
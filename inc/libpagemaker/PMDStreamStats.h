@@ -0,0 +1,88 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDSTREAMSTATS_H__
+#define __PMDSTREAMSTATS_H__
+
+namespace libpagemaker
+{
+
+/**
+  Phases of PMDocument::parse() in which the input stream is accessed.
+*/
+enum PMDStreamPhase
+{
+  /// Checking whether the input is a PageMaker document
+  PMD_STREAM_PHASE_PROBE,
+  /// Opening the PageMaker stream inside the document
+  PMD_STREAM_PHASE_OPEN,
+  /// Reading the PageMaker stream into memory
+  PMD_STREAM_PHASE_LOAD,
+  /// Decoding and output; everything after the PageMaker stream has been read
+  PMD_STREAM_PHASE_PARSE,
+
+  PMD_STREAM_PHASE_COUNT
+};
+
+/**
+  Accesses to the input stream in one phase.
+*/
+struct PMDStreamPhaseStats
+{
+  /// Number of read() calls.
+  unsigned long m_reads;
+  /// Number of bytes returned by read().
+  unsigned long m_bytesRead;
+  /// Number of seek() calls.
+  unsigned long m_seeks;
+  /// Number of seek() calls that moved backward.
+  unsigned long m_backwardSeeks;
+  /// Total distance moved by seek(), in bytes.
+  unsigned long m_seekDistance;
+
+  PMDStreamPhaseStats()
+    : m_reads(0), m_bytesRead(0), m_seeks(0), m_backwardSeeks(0), m_seekDistance(0)
+  { }
+};
+
+/**
+  Accesses to the input stream during a PMDocument::parse() call,
+  including those to the streams inside the document.
+*/
+struct PMDStreamStats
+{
+  PMDStreamPhaseStats m_phases[PMD_STREAM_PHASE_COUNT];
+
+  PMDStreamStats()
+    : m_phases()
+  { }
+
+  static const char *getPhaseName(const PMDStreamPhase phase)
+  {
+    switch (phase)
+    {
+    case PMD_STREAM_PHASE_PROBE:
+      return "probe";
+    case PMD_STREAM_PHASE_OPEN:
+      return "open";
+    case PMD_STREAM_PHASE_LOAD:
+      return "load";
+    case PMD_STREAM_PHASE_PARSE:
+      return "parse";
+    default:
+      return "unknown";
+    }
+  }
+};
+
+} // namespace libpagemaker
+
+#endif // __PMDSTREAMSTATS_H__
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
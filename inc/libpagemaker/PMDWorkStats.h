@@ -0,0 +1,50 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDWORKSTATS_H__
+#define __PMDWORKSTATS_H__
+
+namespace libpagemaker
+{
+
+/**
+  Work done by the parser on the PageMaker stream during a
+  PMDocument::parse() call.
+
+  Every record visited, byte read and seek is one work unit. For
+  well-formed input, the work grows linearly with the size of the
+  stream; inputs that need much more work per byte point to
+  algorithmic complexity problems in the parser.
+*/
+struct PMDWorkStats
+{
+  /// Number of records visited, including the entries of the table of contents.
+  unsigned long m_records;
+  /// Number of bytes read or skipped.
+  unsigned long m_bytesRead;
+  /// Number of seeks.
+  unsigned long m_seeks;
+  /// Whether parsing was stopped because it exceeded PMDParseOptions::m_workBudget.
+  bool m_exceeded;
+
+  PMDWorkStats()
+    : m_records(0), m_bytesRead(0), m_seeks(0), m_exceeded(false)
+  { }
+
+  unsigned long getWorkUnits() const
+  {
+    return m_records + m_bytesRead + m_seeks;
+  }
+};
+
+} // namespace libpagemaker
+
+#endif // __PMDWORKSTATS_H__
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -12,6 +12,12 @@
 
 #include <librevenge/librevenge.h>
 
+#include "PMDImageSink.h"
+#include "PMDParseStats.h"
+#include "PMDProgress.h"
+#include "PMDStreamStats.h"
+#include "PMDWorkStats.h"
+
 #ifdef DLL_EXPORT
 #ifdef LIBPAGEMAKER_BUILD
 #define PAGEMAKERAPI __declspec(dllexport)
@@ -29,6 +35,139 @@
 namespace libpagemaker
 {
 
+/**
+  Kinds of document content, for PMDParseOptions::m_content.
+*/
+enum PMDContent
+{
+  /// Text boxes
+  PMD_CONTENT_TEXT = 1 << 0,
+  /// Lines, rectangles, ellipses and polygons
+  PMD_CONTENT_GRAPHICS = 1 << 1,
+  /// Bitmaps and metafiles
+  PMD_CONTENT_BITMAPS = 1 << 2,
+
+  PMD_CONTENT_ALL = PMD_CONTENT_TEXT | PMD_CONTENT_GRAPHICS | PMD_CONTENT_BITMAPS
+};
+
+/**
+  Reasons why PMDocument::parse() failed, for PMDParseOptions::m_error.
+*/
+enum PMDParseError
+{
+  PMD_ERROR_NONE = 0,
+  /// The input is not a PageMaker document or the arguments are invalid.
+  PMD_ERROR_UNSUPPORTED,
+  /// The document is damaged or uses features that cannot be parsed.
+  PMD_ERROR_PARSE,
+  /// PMDParseOptions::m_timeLimit has been exceeded.
+  PMD_ERROR_TIME_LIMIT,
+  /// PMDParseOptions::m_maxRecords has been exceeded.
+  PMD_ERROR_RECORD_LIMIT,
+  /// PMDParseOptions::m_maxBitmapBytes has been exceeded.
+  PMD_ERROR_BITMAP_LIMIT,
+  /// PMDParseOptions::m_maxPainterCalls has been exceeded.
+  PMD_ERROR_PAINTER_LIMIT,
+  /// PMDParseOptions::m_workBudget has been exceeded.
+  PMD_ERROR_WORK_BUDGET,
+  /// PMDParseOptions::m_progress has cancelled the parsing.
+  PMD_ERROR_CANCELLED
+};
+
+/**
+  Options for PMDocument::parse().
+*/
+struct PMDParseOptions
+{
+  /// Index of the first page to output, counting from 0.
+  unsigned m_firstPage;
+  /// Index of the last page to output. Pages past the end of the document are ignored.
+  unsigned m_lastPage;
+  /**
+    Number of threads used to decode the pages. 1 decodes everything
+    on the calling thread, 0 uses one thread per hardware thread.
+  */
+  unsigned m_threads;
+  /**
+    Paint every page as soon as it has been decoded and release it
+    afterwards, so memory use does not grow with the length of the
+    document. If parsing fails, the painter will already have received
+    the pages before the failure.
+  */
+  bool m_streaming;
+  /// If set, images are passed to the sink instead of being embedded. Not owned.
+  PMDImageSink *m_imageSink;
+  /**
+    Content to output, a combination of PMDContent values. Shapes of
+    other kinds are skipped without being decoded.
+  */
+  unsigned m_content;
+  /// If set, receives the timings of the parsing phases. Not owned.
+  PMDParseStats *m_stats;
+  /// If set, receives counts of the accesses to the input stream. Not owned.
+  PMDStreamStats *m_streamStats;
+  /// If set, receives the work done by the parser, also if parsing fails. Not owned.
+  PMDWorkStats *m_work;
+  /**
+    Maximal number of work units (see PMDWorkStats) the parser may
+    spend; 0 means unlimited. Parsing fails when the budget is
+    exceeded.
+  */
+  unsigned long m_workBudget;
+
+  /*
+    Resource limits. Parsing is stopped as soon as one of them is
+    exceeded and fails with the matching PMDParseError. 0 means
+    unlimited.
+  */
+
+  /**
+    Maximal wall-clock time of the whole call in milliseconds. The time
+    is checked every few records and painter calls, so it may be
+    exceeded slightly.
+  */
+  unsigned m_timeLimit;
+  /// Maximal number of records visited, as counted by PMDWorkStats::m_records.
+  unsigned long m_maxRecords;
+  /// Maximal number of bytes of all images together. With an image sink, repeated images count once.
+  unsigned long m_maxBitmapBytes;
+  /// Maximal number of calls to the painter.
+  unsigned long m_maxPainterCalls;
+
+  /// If set, receives the reason why parsing failed, or PMD_ERROR_NONE. Not owned.
+  PMDParseError *m_error;
+  /// If set, receives the progress of the parsing and may cancel it. Not owned.
+  PMDProgress *m_progress;
+
+  PMDParseOptions()
+    : m_firstPage(0), m_lastPage(static_cast<unsigned>(-1)), m_threads(1), m_streaming(false), m_imageSink(0),
+      m_content(PMD_CONTENT_ALL), m_stats(0), m_streamStats(0), m_work(0), m_workBudget(0),
+      m_timeLimit(0), m_maxRecords(0), m_maxBitmapBytes(0), m_maxPainterCalls(0), m_error(0), m_progress(0)
+  { }
+};
+
+/**
+  Document-level information, as returned by PMDocument::parseInfo().
+*/
+struct PMDDocumentInfo
+{
+  /// Number of pages that PMDocument::parse() outputs.
+  unsigned m_pageCount;
+  /// Page width in inches.
+  double m_pageWidth;
+  /// Page height in inches.
+  double m_pageHeight;
+  bool m_doubleSided;
+  /// Font names, in the order of the document's font table.
+  librevenge::RVNGStringVector m_fonts;
+  /// Colors in the form "#rrggbb", in the order of the document's color table.
+  librevenge::RVNGStringVector m_colors;
+
+  PMDDocumentInfo()
+    : m_pageCount(0), m_pageWidth(0), m_pageHeight(0), m_doubleSided(false), m_fonts(), m_colors()
+  { }
+};
+
 class PMDocument
 {
 public:
@@ -55,6 +194,32 @@ public:
     \return A value that indicates whether the parsing was successful
   */
   static PAGEMAKERAPI bool parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter);
+
+  /**
+    Parses the input stream content, as restricted by options.
+
+    Only the shapes of the pages in the requested page range are
+    decoded, so the cost of extracting a few pages does not depend on
+    the length of the document.
+
+    \param input The input stream
+    \param painter A librevenge::RVNGDrawingInterface implementation
+    \param options The parts of the document to output and the limits of the parsing
+    \return A value that indicates whether the parsing was successful;
+    options.m_error tells why it was not
+  */
+  static PAGEMAKERAPI bool parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, const PMDParseOptions &options);
+
+  /**
+    Reads the document-level information of the input stream content.
+
+    Pages, shapes, text and images are not decoded.
+
+    \param input The input stream
+    \param info The information read from the document
+    \return A value that indicates whether the reading was successful
+  */
+  static PAGEMAKERAPI bool parseInfo(librevenge::RVNGInputStream *input, PMDDocumentInfo &info);
 };
 
 } // namespace libpagemaker
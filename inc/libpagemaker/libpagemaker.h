@@ -10,6 +10,12 @@
 #ifndef __LIBPAGEMAKER_H__
 #define __LIBPAGEMAKER_H__
 
+#include "PMDAllocationTracker.h"
+#include "PMDImageSink.h"
+#include "PMDParseStats.h"
+#include "PMDProgress.h"
+#include "PMDStreamStats.h"
+#include "PMDWorkStats.h"
 #include "PMDocument.h"
 
 #endif // __LIBPAGEMAKER_H__
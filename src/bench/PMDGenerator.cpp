@@ -0,0 +1,587 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "PMDGenerator.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "PMDOLEWriter.h"
+#include "PMDRecordLayout.h"
+#include "constants.h"
+#include "offsets.h"
+
+namespace libpagemaker
+{
+
+namespace
+{
+
+// The parser finds text and bitmap data by their seqNum only.
+const uint8_t TEXT = 0x0d;
+// The type of a ToC entry that refers to a block of subrecords.
+const uint8_t SUBRECORDS = 0x01;
+
+const unsigned HEADER_SIZE = 0x40;
+const unsigned TOC_ENTRY_SIZE = 16;
+const unsigned MAX_RECORDS = 0xffff;
+const unsigned STORIES = 2;
+const unsigned MAX_LINE_SETS = 16;
+const uint32_t FIRST_XFORM_ID = 101;
+const unsigned XFORMS = 3;
+const uint32_t FIRST_TEXT_BLOCK_ID = 1000;
+
+class ByteOrderWriter
+{
+  const bool m_bigEndian;
+
+public:
+  explicit ByteOrderWriter(const bool bigEndian)
+    : m_bigEndian(bigEndian)
+  { }
+
+  void writeU16(unsigned char *const p, const uint16_t value) const
+  {
+    p[m_bigEndian ? 0 : 1] = static_cast<unsigned char>(value >> 8);
+    p[m_bigEndian ? 1 : 0] = static_cast<unsigned char>(value);
+  }
+
+  void writeU32(unsigned char *const p, const uint32_t value) const
+  {
+    writeU16(p + (m_bigEndian ? 0 : 2), static_cast<uint16_t>(value >> 16));
+    writeU16(p + (m_bigEndian ? 2 : 0), static_cast<uint16_t>(value));
+  }
+
+  bool isBigEndian() const
+  {
+    return m_bigEndian;
+  }
+};
+
+/// A fixed-size record, written through the same field descriptors the parser reads.
+class RecordWriter
+{
+  std::vector<unsigned char> m_data;
+  const ByteOrderWriter m_writer;
+
+public:
+  RecordWriter(const unsigned size, const bool bigEndian)
+    : m_data(size, 0), m_writer(bigEndian)
+  { }
+
+  void set(const PMDField<uint8_t> field, const uint8_t value)
+  {
+    m_data[field.m_offset] = value;
+  }
+
+  void set(const PMDField<uint16_t> field, const uint16_t value)
+  {
+    m_writer.writeU16(&m_data[field.m_offset], value);
+  }
+
+  void set(const PMDField<int16_t> field, const int16_t value)
+  {
+    m_writer.writeU16(&m_data[field.m_offset], static_cast<uint16_t>(value));
+  }
+
+  void set(const PMDField<uint32_t> field, const uint32_t value)
+  {
+    m_writer.writeU32(&m_data[field.m_offset], value);
+  }
+
+  void set(const PMDField<PMDShapePoint> field, const int x, const int y)
+  {
+    const int first = m_writer.isBigEndian() ? y : x;
+    const int second = m_writer.isBigEndian() ? x : y;
+    m_writer.writeU16(&m_data[field.m_offset], static_cast<uint16_t>(first));
+    m_writer.writeU16(&m_data[field.m_offset + 2], static_cast<uint16_t>(second));
+  }
+
+  void set(const PMDField<boost::optional<PMDStrokeProperties> > field, const uint8_t type, const uint16_t width,
+           const uint16_t color, const uint16_t tint)
+  {
+    unsigned char *const p = &m_data[field.m_offset];
+    m_writer.writeU16(p, 0x1);
+    p[2] = type;
+    m_writer.writeU32(p + 4, uint32_t(width) << 8);
+    m_writer.writeU16(p + 8, color);
+    m_writer.writeU16(p + 10, tint);
+  }
+
+  void setBytes(const unsigned offset, const std::string &bytes)
+  {
+    std::copy(bytes.begin(), bytes.end(), m_data.begin() + offset);
+  }
+
+  void appendTo(std::vector<unsigned char> &records) const
+  {
+    records.insert(records.end(), m_data.begin(), m_data.end());
+  }
+};
+
+/**
+ * Collects the record containers of a PageMaker stream and writes the
+ * header and the table of contents for them.
+ *
+ * Every top-level ToC entry gets the next seqNum.
+ */
+class StreamBuilder
+{
+  struct Container
+  {
+    uint8_t m_type;
+    uint16_t m_numRecords;
+    uint32_t m_offset;
+  };
+
+  /// No containers: an empty entry; more than one: a block of subrecords.
+  struct Entry
+  {
+    std::vector<Container> m_containers;
+    bool m_subrecords;
+
+    explicit Entry(const bool subrecords = false)
+      : m_containers(), m_subrecords(subrecords)
+    { }
+  };
+
+  std::vector<unsigned char> m_data;
+  const ByteOrderWriter m_writer;
+  std::vector<Entry> m_toc;
+
+  uint32_t append(const unsigned char *const data, const std::size_t length)
+  {
+    const std::size_t offset = m_data.size();
+    m_data.insert(m_data.end(), data, data + length);
+    return static_cast<uint32_t>(offset);
+  }
+
+  void writeEntry(const uint8_t type, const uint16_t numRecords, const uint32_t offset, std::vector<unsigned char> &toc, const bool topLevel) const
+  {
+    unsigned char entry[TOC_ENTRY_SIZE] = { 0 };
+    entry[1] = type;
+    m_writer.writeU16(entry + 2, numRecords);
+    m_writer.writeU32(entry + 4, offset);
+    if (topLevel)
+      entry[11] = type;
+    toc.insert(toc.end(), entry, entry + (topLevel ? TOC_ENTRY_SIZE : 10));
+  }
+
+public:
+  explicit StreamBuilder(const bool bigEndian)
+    : m_data(HEADER_SIZE, 0), m_writer(bigEndian), m_toc()
+  {
+    m_writer.writeU16(&m_data[ENDIANNESS_MARKER_OFFSET], ENDIANNESS_MARKER);
+  }
+
+  /// Adds a container of numRecords records. Returns its seqNum.
+  unsigned addRecords(const uint8_t type, const std::vector<unsigned char> &records, const unsigned numRecords)
+  {
+    if (numRecords > MAX_RECORDS)
+      throw std::invalid_argument("too many records in a container");
+    Entry entry;
+    const Container container = { type, static_cast<uint16_t>(numRecords), append(records.data(), records.size()) };
+    entry.m_containers.push_back(container);
+    m_toc.push_back(entry);
+    return static_cast<unsigned>(m_toc.size() - 1);
+  }
+
+  /// Adds a sequence of records, split into several containers with the same seqNum.
+  unsigned addSplitRecords(const uint8_t type, const std::vector<unsigned char> &records, const unsigned recordSize)
+  {
+    const std::size_t numRecords = records.size() / recordSize;
+    const std::size_t parts = std::min<std::size_t>(numRecords, std::max<std::size_t>(2, (numRecords + MAX_RECORDS - 1) / MAX_RECORDS));
+    if (parts == 0 || parts > MAX_RECORDS)
+      throw std::invalid_argument("invalid number of records");
+    Entry entry(true);
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i != parts; ++i)
+    {
+      const std::size_t end = numRecords * (i + 1) / parts;
+      const Container container = { type, static_cast<uint16_t>(end - begin), append(records.data() + begin * recordSize, (end - begin) * recordSize) };
+      entry.m_containers.push_back(container);
+      begin = end;
+    }
+    m_toc.push_back(entry);
+    return static_cast<unsigned>(m_toc.size() - 1);
+  }
+
+  unsigned addEmpty()
+  {
+    m_toc.push_back(Entry());
+    return static_cast<unsigned>(m_toc.size() - 1);
+  }
+
+  /// Replaces an entry added by addEmpty() with a container.
+  void setRecords(const unsigned seqNum, const uint8_t type, const std::vector<unsigned char> &records, const unsigned numRecords)
+  {
+    addRecords(type, records, numRecords);
+    m_toc[seqNum] = m_toc.back();
+    m_toc.pop_back();
+  }
+
+  std::vector<unsigned char> finish()
+  {
+    if (m_toc.size() > MAX_RECORDS)
+      throw std::invalid_argument("too many records in the table of contents");
+
+    std::vector<unsigned char> toc;
+    for (const auto &entry : m_toc)
+    {
+      if (entry.m_containers.empty())
+      {
+        toc.insert(toc.end(), TOC_ENTRY_SIZE, 0);
+      }
+      else if (!entry.m_subrecords)
+      {
+        const Container &container = entry.m_containers.front();
+        writeEntry(container.m_type, container.m_numRecords, container.m_offset, toc, true);
+      }
+      else
+      {
+        std::vector<unsigned char> subToc;
+        for (const auto &container : entry.m_containers)
+          writeEntry(container.m_type, container.m_numRecords, container.m_offset, subToc, false);
+        const uint32_t subTocOffset = append(subToc.data(), subToc.size());
+        writeEntry(SUBRECORDS, static_cast<uint16_t>(entry.m_containers.size()), subTocOffset, toc, true);
+        toc[toc.size() - TOC_ENTRY_SIZE + 11] = entry.m_containers.front().m_type;
+      }
+    }
+    const uint32_t tocOffset = append(toc.data(), toc.size());
+    m_writer.writeU16(&m_data[TABLE_OF_CONTENTS_LENGTH_OFFSET], static_cast<uint16_t>(m_toc.size()));
+    m_writer.writeU32(&m_data[TABLE_OF_CONTENTS_OFFSET_OFFSET], tocOffset);
+
+    // Short streams would have to go into the OLE mini stream.
+    if (m_data.size() < OLE_MINI_STREAM_CUTOFF)
+      m_data.resize(OLE_MINI_STREAM_CUTOFF, 0);
+    return m_data;
+  }
+};
+
+class Generator
+{
+  const PMDGeneratorOptions &m_options;
+  const bool m_bigEndian;
+  StreamBuilder m_builder;
+  std::mt19937 m_random;
+  std::vector<uint16_t> m_bitmapSeqNums;
+  std::vector<uint16_t> m_lineSetSeqNums;
+  unsigned m_polygons;
+
+  unsigned random(const unsigned n)
+  {
+    return static_cast<unsigned>(m_random() % n);
+  }
+
+  int random(const int low, const int high)
+  {
+    return low + int(random(unsigned(high - low)));
+  }
+
+  RecordWriter newRecord(const unsigned size) const
+  {
+    return RecordWriter(size, m_bigEndian);
+  }
+
+  void addGlobalInfo()
+  {
+    RecordWriter record = newRecord(GLOBAL_INFO_RECORD_SIZE);
+    if (m_options.m_doubleSided)
+      record.set(GlobalInfoRecord::OPTIONS, m_bigEndian ? 0x40 : 0x2);
+    // US Letter
+    record.set(GlobalInfoRecord::PAGE_TOP_LEFT, -6120, -7920);
+    record.set(GlobalInfoRecord::PAGE_BOT_RIGHT, 6120, 7920);
+    std::vector<unsigned char> records;
+    record.appendTo(records);
+    m_builder.addRecords(GLOBAL_INFO, records, 1);
+  }
+
+  void addFonts()
+  {
+    static const char *const FONT_NAMES[] = { "Times", "Helvetica", "Courier" };
+    std::vector<unsigned char> records;
+    for (const char *name : FONT_NAMES)
+    {
+      RecordWriter record = newRecord(FONTS_RECORD_SIZE);
+      record.setBytes(0, name);
+      record.appendTo(records);
+    }
+    m_builder.addRecords(FONTS, records, 3);
+  }
+
+  void addColors()
+  {
+    std::vector<unsigned char> records;
+    for (unsigned i = 0; i != 4; ++i)
+    {
+      RecordWriter record = newRecord(COLORS_RECORD_SIZE);
+      if (i == 2)
+      {
+        record.set(ColorRecord::MODEL, CMYK);
+        record.set(ColorRecord::CYAN, 0xffff);
+        record.set(ColorRecord::YELLOW, 0x8000);
+      }
+      else
+      {
+        record.set(ColorRecord::MODEL, RGB);
+        record.set(ColorRecord::RED, i == 1 ? 0xff : 0);
+        record.set(ColorRecord::BLUE, i == 3 ? 0xff : 0);
+      }
+      record.appendTo(records);
+    }
+    m_builder.addRecords(COLORS, records, 4);
+  }
+
+  void addXForms()
+  {
+    std::vector<unsigned char> records;
+    for (unsigned i = 1; i <= XFORMS; ++i)
+    {
+      RecordWriter record = newRecord(XFORM_RECORD_SIZE);
+      record.set(XFormRecord::ROTATION, i * 15000);
+      record.set(XFormRecord::SKEW, i * 2000);
+      record.set(XFormRecord::TOP_LEFT, -500 * int(i), -400 * int(i));
+      record.set(XFormRecord::BOT_RIGHT, 500 * int(i), 400 * int(i));
+      record.set(XFormRecord::ROTATING_POINT, -300, -200);
+      record.set(XFormRecord::ID, FIRST_XFORM_ID + i - 1);
+      record.appendTo(records);
+    }
+    m_builder.addRecords(XFORM, records, XFORMS);
+  }
+
+  void addStories()
+  {
+    const unsigned length = m_options.m_textLength;
+    std::vector<unsigned char> textBlocks;
+    for (unsigned i = 0; i != STORIES; ++i)
+    {
+      std::vector<unsigned char> text(length);
+      for (unsigned j = 0; j != length; ++j)
+      {
+        const unsigned r = random(64);
+        text[j] = r < 8 ? ' ' : r == 8 ? '\t' : r == 9 ? '\r' : static_cast<unsigned char>('a' + r % 26);
+      }
+      const unsigned textSeqNum = m_builder.addSplitRecords(TEXT, text, 1);
+
+      std::vector<unsigned char> chars;
+      static const uint16_t CHAR_FLAGS[] = { 0x1, 0x2, 0x204 };
+      for (unsigned k = 0; k != 3; ++k)
+      {
+        RecordWriter record = newRecord(CHARS_RECORD_SIZE);
+        record.set(CharsRecord::LENGTH, static_cast<uint16_t>(length / 3 + 1));
+        record.set(CharsRecord::FONT_FACE, static_cast<uint16_t>(k));
+        record.set(CharsRecord::FONT_SIZE, static_cast<uint16_t>(120 + 10 * k));
+        record.set(CharsRecord::FONT_COLOR, static_cast<uint16_t>(k + 1));
+        record.set(CharsRecord::FLAGS, CHAR_FLAGS[k]);
+        record.set(CharsRecord::KERNING, static_cast<int16_t>(-20 * int(k)));
+        record.set(CharsRecord::SUPER_SUB_SIZE, 583);
+        record.set(CharsRecord::SUB_POS, 333);
+        record.set(CharsRecord::SUPER_POS, 333);
+        record.set(CharsRecord::TINT, static_cast<uint16_t>(100 - 10 * k));
+        record.appendTo(chars);
+      }
+      const unsigned charsSeqNum = m_builder.addRecords(CHARS, chars, 3);
+
+      std::vector<unsigned char> paras;
+      for (unsigned k = 0; k != 2; ++k)
+      {
+        RecordWriter record = newRecord(PARA_RECORD_SIZE);
+        record.set(ParaRecord::LENGTH, static_cast<uint16_t>(length / 2 + k));
+        record.set(ParaRecord::FLAGS, static_cast<uint8_t>(0x8 * k));
+        record.set(ParaRecord::ALIGN, static_cast<uint8_t>(k + 1));
+        record.set(ParaRecord::LEFT_INDENT, static_cast<uint16_t>(100 * k));
+        record.set(ParaRecord::FIRST_INDENT, 50);
+        record.set(ParaRecord::BEFORE_INDENT, 30);
+        record.set(ParaRecord::HYPHENS_COUNT, static_cast<uint8_t>(k));
+        record.set(ParaRecord::KEEP_OPTIONS, 0x93);
+        record.set(ParaRecord::RULE_ABOVE, STROKE_DASHED, 0x1234, 2, 80);
+        if (k)
+          record.set(ParaRecord::RULE_BELOW, STROKE_NORMAL, 0x500, 1, 100);
+        record.appendTo(paras);
+      }
+      const unsigned paraSeqNum = m_builder.addRecords(PARA, paras, 2);
+
+      RecordWriter textBlock = newRecord(TEXT_BLOCK_RECORD_SIZE);
+      textBlock.set(TextBlockRecord::PROPS_ONE, 1);
+      textBlock.set(TextBlockRecord::PROPS_TWO, 2);
+      textBlock.set(TextBlockRecord::TEXT_SEQ_NUM, static_cast<uint16_t>(textSeqNum));
+      textBlock.set(TextBlockRecord::CHARS_SEQ_NUM, static_cast<uint16_t>(charsSeqNum));
+      textBlock.set(TextBlockRecord::PARA_SEQ_NUM, static_cast<uint16_t>(paraSeqNum));
+      textBlock.set(TextBlockRecord::STYLE, 3);
+      textBlock.set(TextBlockRecord::ID, FIRST_TEXT_BLOCK_ID + i);
+      textBlock.appendTo(textBlocks);
+    }
+    m_builder.addRecords(TEXT_BLOCK, textBlocks, STORIES);
+  }
+
+  void addBitmaps()
+  {
+    for (unsigned i = 0; i != m_options.m_bitmaps; ++i)
+    {
+      std::vector<unsigned char> data(m_options.m_bitmapSize);
+      for (auto &byte : data)
+        byte = static_cast<unsigned char>(random(256));
+      m_bitmapSeqNums.push_back(static_cast<uint16_t>(m_builder.addSplitRecords(TIFF, data, 1)));
+    }
+  }
+
+  /// Polygons use a limited number of line sets in turn, to keep the ToC small.
+  uint16_t getLineSet()
+  {
+    const unsigned index = m_polygons++ % MAX_LINE_SETS;
+    if (index < m_lineSetSeqNums.size())
+      return m_lineSetSeqNums[index];
+
+    std::vector<unsigned char> points;
+    RecordWriter point = newRecord(LINE_SET_RECORD_SIZE);
+    const PMDField<PMDShapePoint> POINT = { 0 };
+    for (unsigned i = 0; i != m_options.m_polygonPoints; ++i)
+    {
+      point.set(POINT, random(-500, 500), random(-500, 500));
+      point.appendTo(points);
+    }
+    // The parser has to join points from several containers.
+    const unsigned seqNum = m_builder.addSplitRecords(LINE_SET, points, LINE_SET_RECORD_SIZE);
+    m_lineSetSeqNums.push_back(static_cast<uint16_t>(seqNum));
+    return static_cast<uint16_t>(seqNum);
+  }
+
+  void addShape(const unsigned kind, std::vector<unsigned char> &shapes)
+  {
+    static const uint8_t SHAPE_KINDS[] = { LINE_RECORD, RECTANGLE_RECORD, ELLIPSE_RECORD, POLYGON_RECORD, TEXT_RECORD, BITMAP_RECORD };
+    const uint8_t type = m_options.m_shapeType ? m_options.m_shapeType : SHAPE_KINDS[kind % 6];
+
+    RecordWriter record = newRecord(SHAPE_RECORD_SIZE);
+    record.set(ShapeRecord::TYPE, type);
+    const int left = random(-6000, 5000);
+    const int top = random(-7000, 6000);
+    record.set(ShapeRecord::BBOX_TOP_LEFT, left, top);
+    record.set(ShapeRecord::BBOX_BOT_RIGHT, left + random(100, 1000), top + random(100, 1000));
+    const unsigned xForm = random(XFORMS + 1);
+    const uint32_t xFormId = xForm == XFORMS ? 0 : FIRST_XFORM_ID + xForm;
+
+    switch (type)
+    {
+    case LINE_RECORD:
+      record.set(LineShape::STROKE_COLOR, 2);
+      record.set(LineShape::MIRRORED, random(2) ? 257 : 0);
+      record.set(LineShape::STROKE_TYPE, random(2) ? STROKE_DASHED : STROKE_NORMAL);
+      record.set(LineShape::STROKE_WIDTH, 7);
+      record.set(LineShape::STROKE_TINT, 50);
+      record.set(LineShape::STROKE_OVERPRINT, 1);
+      break;
+    case TEXT_RECORD:
+      record.set(ShapeRecord::XFORM_ID, xFormId);
+      record.set(TextBoxShape::TEXT_BLOCK_ID, FIRST_TEXT_BLOCK_ID + random(STORIES));
+      break;
+    case BITMAP_RECORD:
+      record.set(ShapeRecord::XFORM_ID, xFormId);
+      record.set(BitmapShape::TIFF_SEQ_NUM, m_bitmapSeqNums[random(unsigned(m_bitmapSeqNums.size()))]);
+      break;
+    default:
+      record.set(ShapeRecord::XFORM_ID, xFormId);
+      record.set(FilledShape::FILL_OVERPRINT, 1);
+      record.set(FilledShape::FILL_COLOR, static_cast<uint8_t>(random(4)));
+      record.set(FilledShape::FILL_TYPE, random(2) ? FILL_SOLID : FILL_NONE);
+      record.set(FilledShape::FILL_TINT, 40);
+      record.set(FilledShape::STROKE_TYPE, random(2) ? STROKE_DASHED : STROKE_NORMAL);
+      record.set(FilledShape::STROKE_WIDTH, 9);
+      record.set(FilledShape::STROKE_COLOR, static_cast<uint8_t>(random(4)));
+      record.set(FilledShape::STROKE_OVERPRINT, 1);
+      record.set(FilledShape::STROKE_TINT, 70);
+      if (type == POLYGON_RECORD)
+      {
+        static const uint8_t CLOSED_MARKERS[] = { REGULAR_POLYGON, POLYGON_OPEN, POLYGON_CLOSED };
+        record.set(PolygonShape::LINE_SET_SEQ_NUM, getLineSet());
+        record.set(PolygonShape::CLOSED_MARKER, CLOSED_MARKERS[random(3)]);
+      }
+      break;
+    }
+    record.appendTo(shapes);
+  }
+
+public:
+  explicit Generator(const PMDGeneratorOptions &options)
+    : m_options(options), m_bigEndian(options.m_bigEndian), m_builder(options.m_bigEndian), m_random(options.m_seed),
+      m_bitmapSeqNums(), m_lineSetSeqNums(), m_polygons(0)
+  { }
+
+  std::vector<unsigned char> generate(std::vector<unsigned> *const shapesSeqNums)
+  {
+    addGlobalInfo();
+    const unsigned pageSeqNum = m_builder.addEmpty();
+    addFonts();
+    addColors();
+    addXForms();
+    m_builder.addEmpty();
+    addStories();
+    addBitmaps();
+
+    std::vector<unsigned char> pages;
+    for (unsigned i = 0; i != m_options.m_pages; ++i)
+    {
+      std::vector<unsigned char> shapes;
+      for (unsigned k = 0; k != m_options.m_shapesPerPage; ++k)
+        addShape(k + i, shapes);
+      const unsigned shapesSeqNum = m_builder.addRecords(SHAPE, shapes, m_options.m_shapesPerPage);
+      if (shapesSeqNums)
+        shapesSeqNums->push_back(shapesSeqNum);
+
+      RecordWriter page = newRecord(PAGE_RECORD_SIZE);
+      page.set(PageRecord::SHAPES_SEQ_NUM, static_cast<uint16_t>(shapesSeqNum));
+      page.set(PageRecord::WIDTH, 12240);
+      page.appendTo(pages);
+    }
+    m_builder.setRecords(pageSeqNum, PAGE, pages, m_options.m_pages);
+
+    return m_builder.finish();
+  }
+};
+
+}
+
+std::vector<unsigned char> generatePageMakerStream(const PMDGeneratorOptions &options, std::vector<unsigned> *const shapesSeqNums)
+{
+  if (options.m_pages == 0 || options.m_pages > MAX_RECORDS)
+    throw std::invalid_argument("the number of pages must be between 1 and 65535");
+  if (options.m_shapesPerPage > MAX_RECORDS)
+    throw std::invalid_argument("the number of shapes per page must be at most 65535");
+  if (options.m_textLength == 0 || options.m_textLength > MAX_RECORDS)
+    throw std::invalid_argument("the text length must be between 1 and 65535");
+  if (options.m_polygonPoints < 2 || options.m_polygonPoints > MAX_RECORDS)
+    throw std::invalid_argument("the number of polygon points must be between 2 and 65535");
+  if (options.m_bitmapSize == 0 || options.m_bitmaps == 0)
+    throw std::invalid_argument("the bitmap size and count must not be 0");
+  switch (options.m_shapeType)
+  {
+  case 0:
+  case LINE_RECORD:
+  case RECTANGLE_RECORD:
+  case ELLIPSE_RECORD:
+  case POLYGON_RECORD:
+  case TEXT_RECORD:
+  case BITMAP_RECORD:
+    break;
+  default:
+    throw std::invalid_argument("unsupported shape type");
+  }
+
+  return Generator(options).generate(shapesSeqNums);
+}
+
+std::vector<unsigned char> generatePageMakerDocument(const PMDGeneratorOptions &options, std::vector<unsigned> *const shapesSeqNums)
+{
+  return writeOLEDocument("PageMaker", generatePageMakerStream(options, shapesSeqNums));
+}
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,70 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDGENERATOR_H__
+#define __PMDGENERATOR_H__
+
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+namespace libpagemaker
+{
+
+/**
+ * Parameters of a generated document.
+ */
+struct PMDGeneratorOptions
+{
+  unsigned m_pages;
+  unsigned m_shapesPerPage;
+  /// Number of characters of each story.
+  unsigned m_textLength;
+  /// Number of points of each polygon.
+  unsigned m_polygonPoints;
+  /// Number of bytes of each bitmap.
+  unsigned m_bitmapSize;
+  /// Number of distinct bitmaps; the bitmap shapes use them in turn.
+  unsigned m_bitmaps;
+  /// Record type of all shapes; 0 to use all supported kinds in turn.
+  uint8_t m_shapeType;
+  bool m_bigEndian;
+  bool m_doubleSided;
+  /// Seed of the pseudo-random shape positions and properties.
+  unsigned m_seed;
+
+  PMDGeneratorOptions()
+    : m_pages(1), m_shapesPerPage(6), m_textLength(60), m_polygonPoints(7), m_bitmapSize(300), m_bitmaps(1),
+      m_shapeType(0), m_bigEndian(false), m_doubleSided(false), m_seed(1)
+  { }
+};
+
+/**
+ * Generates a PageMaker stream, as read by PMDParser.
+ *
+ * The shapes on the pages cycle through all the kinds the parser
+ * supports. Throws std::invalid_argument if the options exceed the
+ * limits of the format.
+ *
+ * If shapesSeqNums is not null, it receives the seqNums of the shape
+ * records of every page.
+ */
+std::vector<unsigned char> generatePageMakerStream(const PMDGeneratorOptions &options, std::vector<unsigned> *shapesSeqNums = nullptr);
+
+/**
+ * Generates a complete PageMaker document, i.e., the PageMaker stream
+ * wrapped in an OLE container.
+ */
+std::vector<unsigned char> generatePageMakerDocument(const PMDGeneratorOptions &options, std::vector<unsigned> *shapesSeqNums = nullptr);
+
+}
+
+#endif /* __PMDGENERATOR_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,174 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "PMDOLEWriter.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+
+namespace libpagemaker
+{
+
+namespace
+{
+
+const unsigned SECTOR_SIZE = 512;
+const unsigned HEADER_SIZE = 512;
+const unsigned DIRECTORY_ENTRY_SIZE = 128;
+const unsigned IDS_PER_SECTOR = SECTOR_SIZE / 4;
+const unsigned HEADER_DIFAT_SIZE = 109;
+
+const uint32_t DIFSECT = 0xfffffffc;
+const uint32_t FATSECT = 0xfffffffd;
+const uint32_t ENDOFCHAIN = 0xfffffffe;
+const uint32_t FREESECT = 0xffffffff;
+const uint32_t NOSTREAM = 0xffffffff;
+
+const uint8_t OBJECT_STREAM = 2;
+const uint8_t OBJECT_ROOT = 5;
+const uint8_t COLOR_BLACK = 1;
+
+void writeU16(std::vector<unsigned char> &data, const std::size_t offset, const uint16_t value)
+{
+  data[offset] = static_cast<unsigned char>(value);
+  data[offset + 1] = static_cast<unsigned char>(value >> 8);
+}
+
+void writeU32(std::vector<unsigned char> &data, const std::size_t offset, const uint32_t value)
+{
+  writeU16(data, offset, static_cast<uint16_t>(value));
+  writeU16(data, offset + 2, static_cast<uint16_t>(value >> 16));
+}
+
+std::size_t sectorOffset(const uint32_t sector)
+{
+  return HEADER_SIZE + std::size_t(sector) * SECTOR_SIZE;
+}
+
+unsigned divideRoundingUp(const std::size_t value, const std::size_t divisor)
+{
+  return static_cast<unsigned>((value + divisor - 1) / divisor);
+}
+
+void writeDirectoryEntry(std::vector<unsigned char> &data, const std::size_t offset, const std::string &name,
+                         const uint8_t type, const uint32_t child, const uint32_t start, const uint32_t size)
+{
+  for (std::size_t i = 0; i != name.size(); ++i)
+    writeU16(data, offset + 2 * i, static_cast<uint16_t>(name[i]));
+  writeU16(data, offset + 0x40, static_cast<uint16_t>(2 * (name.size() + 1)));
+  data[offset + 0x42] = type;
+  data[offset + 0x43] = COLOR_BLACK;
+  writeU32(data, offset + 0x44, NOSTREAM);
+  writeU32(data, offset + 0x48, NOSTREAM);
+  writeU32(data, offset + 0x4c, child);
+  writeU32(data, offset + 0x74, start);
+  writeU32(data, offset + 0x78, size);
+}
+
+}
+
+std::vector<unsigned char> writeOLEDocument(const std::string &streamName, const std::vector<unsigned char> &stream)
+{
+  if (stream.size() < OLE_MINI_STREAM_CUTOFF)
+    throw std::invalid_argument("stream is too short to be stored outside of the mini stream");
+  if (stream.size() > 0x7fffffff)
+    throw std::invalid_argument("stream is too long");
+  if (streamName.empty() || streamName.size() >= 32)
+    throw std::invalid_argument("invalid stream name");
+
+  // Layout: stream data, one directory sector, the FAT, the DIFAT (if the
+  // header's FAT list does not suffice). The sizes of the last two depend
+  // on each other, so iterate until they are stable.
+  const unsigned dataSectors = divideRoundingUp(stream.size(), SECTOR_SIZE);
+  const uint32_t directorySector = dataSectors;
+  unsigned fatSectors = 0;
+  unsigned difatSectors = 0;
+  while (true)
+  {
+    const unsigned sectors = dataSectors + 1 + fatSectors + difatSectors;
+    const unsigned neededFatSectors = divideRoundingUp(sectors, IDS_PER_SECTOR);
+    const unsigned neededDifatSectors = neededFatSectors > HEADER_DIFAT_SIZE ? divideRoundingUp(neededFatSectors - HEADER_DIFAT_SIZE, IDS_PER_SECTOR - 1) : 0;
+    if (neededFatSectors == fatSectors && neededDifatSectors == difatSectors)
+      break;
+    fatSectors = neededFatSectors;
+    difatSectors = neededDifatSectors;
+  }
+  const uint32_t firstFatSector = directorySector + 1;
+  const uint32_t firstDifatSector = firstFatSector + fatSectors;
+  const unsigned sectors = dataSectors + 1 + fatSectors + difatSectors;
+
+  std::vector<unsigned char> data(sectorOffset(sectors), 0);
+
+  // header
+  static const unsigned char SIGNATURE[] = { 0xd0, 0xcf, 0x11, 0xe0, 0xa1, 0xb1, 0x1a, 0xe1 };
+  std::copy(SIGNATURE, SIGNATURE + sizeof(SIGNATURE), data.begin());
+  writeU16(data, 0x18, 0x003e); // minor version
+  writeU16(data, 0x1a, 0x0003); // major version
+  writeU16(data, 0x1c, 0xfffe); // byte order
+  writeU16(data, 0x1e, 9); // sector shift
+  writeU16(data, 0x20, 6); // mini sector shift
+  writeU32(data, 0x2c, fatSectors);
+  writeU32(data, 0x30, directorySector);
+  writeU32(data, 0x38, OLE_MINI_STREAM_CUTOFF);
+  writeU32(data, 0x3c, ENDOFCHAIN); // first mini FAT sector
+  writeU32(data, 0x40, 0); // number of mini FAT sectors
+  writeU32(data, 0x44, difatSectors ? firstDifatSector : ENDOFCHAIN);
+  writeU32(data, 0x48, difatSectors);
+  for (unsigned i = 0; i != HEADER_DIFAT_SIZE; ++i)
+    writeU32(data, 0x4c + 4 * i, i < fatSectors ? firstFatSector + i : FREESECT);
+
+  // stream data
+  std::copy(stream.begin(), stream.end(), data.begin() + sectorOffset(0));
+
+  // directory
+  const std::size_t directory = sectorOffset(directorySector);
+  writeDirectoryEntry(data, directory, "Root Entry", OBJECT_ROOT, 1, ENDOFCHAIN, 0);
+  writeDirectoryEntry(data, directory + DIRECTORY_ENTRY_SIZE, streamName, OBJECT_STREAM, NOSTREAM, 0, static_cast<uint32_t>(stream.size()));
+  for (unsigned i = 2; i != SECTOR_SIZE / DIRECTORY_ENTRY_SIZE; ++i)
+  {
+    const std::size_t entry = directory + i * DIRECTORY_ENTRY_SIZE;
+    writeU32(data, entry + 0x44, NOSTREAM);
+    writeU32(data, entry + 0x48, NOSTREAM);
+    writeU32(data, entry + 0x4c, NOSTREAM);
+  }
+
+  // FAT
+  for (unsigned i = 0; i != fatSectors * IDS_PER_SECTOR; ++i)
+  {
+    uint32_t next = FREESECT;
+    if (i + 1 < dataSectors)
+      next = i + 1;
+    else if (i + 1 == dataSectors || i == directorySector)
+      next = ENDOFCHAIN;
+    else if (i >= firstFatSector && i < firstDifatSector)
+      next = FATSECT;
+    else if (i >= firstDifatSector && i < sectors)
+      next = DIFSECT;
+    writeU32(data, sectorOffset(firstFatSector + i / IDS_PER_SECTOR) + 4 * (i % IDS_PER_SECTOR), next);
+  }
+
+  // DIFAT
+  for (unsigned i = 0; i != difatSectors; ++i)
+  {
+    const std::size_t sector = sectorOffset(firstDifatSector + i);
+    for (unsigned j = 0; j != IDS_PER_SECTOR - 1; ++j)
+    {
+      const unsigned fatIndex = HEADER_DIFAT_SIZE + i * (IDS_PER_SECTOR - 1) + j;
+      writeU32(data, sector + 4 * j, fatIndex < fatSectors ? firstFatSector + fatIndex : FREESECT);
+    }
+    writeU32(data, sector + 4 * (IDS_PER_SECTOR - 1), i + 1 < difatSectors ? firstDifatSector + i + 1 : ENDOFCHAIN);
+  }
+
+  return data;
+}
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,37 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDOLEWRITER_H__
+#define __PMDOLEWRITER_H__
+
+#include <string>
+#include <vector>
+
+namespace libpagemaker
+{
+
+/// Streams shorter than this would have to go into the mini stream.
+const unsigned OLE_MINI_STREAM_CUTOFF = 4096;
+
+/**
+ * Wraps a single stream into an OLE compound document (version 3, with
+ * 512-byte sectors).
+ *
+ * Only what is needed for generated test documents is supported: the
+ * stream must be at least OLE_MINI_STREAM_CUTOFF bytes long, so the
+ * mini stream is never used, and its name must be ASCII and shorter
+ * than 32 characters. Throws std::invalid_argument otherwise.
+ */
+std::vector<unsigned char> writeOLEDocument(const std::string &streamName, const std::vector<unsigned char> &stream);
+
+}
+
+#endif /* __PMDOLEWRITER_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
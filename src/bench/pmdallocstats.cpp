@@ -0,0 +1,219 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/*
+ * Prints the memory allocations made while a document is parsed.
+ *
+ * This tool replaces the global operator new and operator delete to feed
+ * PMDAllocationTracker, so every allocation in it carries a header. That
+ * is why it is a separate tool and not an option of pmd2raw.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <cstddef>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <librevenge-generators/librevenge-generators.h>
+#include <librevenge-generators/RVNGDummyDrawingGenerator.h>
+#include <librevenge-stream/librevenge-stream.h>
+
+#include <libpagemaker/libpagemaker.h>
+
+#ifndef PACKAGE
+#define PACKAGE "libpagemaker"
+#endif
+#ifndef VERSION
+#define VERSION "UNKNOWN VERSION"
+#endif
+
+#define TOOL "pmdallocstats"
+
+namespace
+{
+
+int printUsage()
+{
+  printf("`" TOOL "' prints the memory allocations made by " PACKAGE ".\n");
+  printf("\n");
+  printf("Usage: " TOOL " [OPTION] INPUT\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("\t--raw                 paint with the raw generator instead of a dummy one\n");
+  printf("\t--help                show this help message\n");
+  printf("\t--version             show version information and exit\n");
+  return -1;
+}
+
+int printVersion()
+{
+  printf(TOOL " " VERSION "\n");
+  return 0;
+}
+
+void printCounts(const char *const name, const libpagemaker::PMDAllocationCounts &counts)
+{
+  fprintf(stderr, "%-10s %12lu %14lu %14lu\n", name, counts.m_allocations, counts.m_bytes, counts.m_peakBytes);
+}
+
+void printAllocationStats(const libpagemaker::PMDAllocationStats &stats)
+{
+  static const char *const phaseNames[] = { "other", "parse", "layout", "paint" };
+  static const char *const shapeNames[] = { "none", "line", "rectangle", "polygon", "ellipse", "text", "bitmap" };
+
+  fprintf(stderr, "%-10s %12s %14s %14s\n", "", "allocations", "bytes", "peak bytes");
+  printCounts("total", stats.m_total);
+  for (unsigned i = 0; i != libpagemaker::PMD_ALLOCATION_PHASE_COUNT; ++i)
+    printCounts(phaseNames[i], stats.m_phases[i]);
+  for (unsigned i = 0; i != libpagemaker::PMD_ALLOCATION_SHAPE_COUNT; ++i)
+    printCounts(shapeNames[i], stats.m_shapes[i]);
+}
+
+/*
+ * Every allocation is preceded by a header that keeps its size and the
+ * tag from the allocation tracker.
+ */
+struct AllocationHeader
+{
+  std::size_t m_size;
+  unsigned m_tag;
+};
+
+const std::size_t ALLOCATION_HEADER_SIZE = (sizeof(AllocationHeader) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+void *allocate(const std::size_t size) noexcept
+{
+  unsigned char *const block = static_cast<unsigned char *>(malloc(ALLOCATION_HEADER_SIZE + size));
+  if (!block)
+    return nullptr;
+  AllocationHeader *const header = reinterpret_cast<AllocationHeader *>(block);
+  header->m_size = size;
+  header->m_tag = libpagemaker::PMDAllocationTracker::allocated(size);
+  return block + ALLOCATION_HEADER_SIZE;
+}
+
+void deallocate(void *const ptr) noexcept
+{
+  if (!ptr)
+    return;
+  unsigned char *const block = static_cast<unsigned char *>(ptr) - ALLOCATION_HEADER_SIZE;
+  const AllocationHeader *const header = reinterpret_cast<const AllocationHeader *>(block);
+  libpagemaker::PMDAllocationTracker::deallocated(header->m_tag, header->m_size);
+  free(block);
+}
+
+} // anonymous namespace
+
+void *operator new(const std::size_t size)
+{
+  void *const ptr = allocate(size);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void *operator new[](const std::size_t size)
+{
+  return operator new(size);
+}
+
+void *operator new(const std::size_t size, const std::nothrow_t &) noexcept
+{
+  return allocate(size);
+}
+
+void *operator new[](const std::size_t size, const std::nothrow_t &) noexcept
+{
+  return allocate(size);
+}
+
+void operator delete(void *const ptr) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete[](void *const ptr) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete(void *const ptr, std::size_t) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete[](void *const ptr, std::size_t) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete(void *const ptr, const std::nothrow_t &) noexcept
+{
+  deallocate(ptr);
+}
+
+void operator delete[](void *const ptr, const std::nothrow_t &) noexcept
+{
+  deallocate(ptr);
+}
+
+int main(int argc, char *argv[])
+{
+  bool raw = false;
+  char *file = nullptr;
+
+  if (argc < 2)
+    return printUsage();
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "--raw"))
+      raw = true;
+    else if (!strcmp(argv[i], "--version"))
+      return printVersion();
+    else if (!file && strncmp(argv[i], "--", 2))
+      file = argv[i];
+    else
+      return printUsage();
+  }
+
+  if (!file)
+    return printUsage();
+
+  librevenge::RVNGFileStream input(file);
+
+  if (!libpagemaker::PMDocument::isSupported(&input))
+  {
+    fprintf(stderr, "ERROR: Unsupported file format (unsupported version) or file is encrypted!\n");
+    return 1;
+  }
+
+  librevenge::RVNGRawDrawingGenerator rawPainter(false);
+  librevenge::RVNGDummyDrawingGenerator dummyPainter;
+  librevenge::RVNGDrawingInterface *const painter = raw ? static_cast<librevenge::RVNGDrawingInterface *>(&rawPainter) : &dummyPainter;
+
+  libpagemaker::PMDAllocationTracker::start();
+  const bool parsed = libpagemaker::PMDocument::parse(&input, painter);
+  libpagemaker::PMDAllocationTracker::stop();
+  if (!parsed)
+    return 1;
+
+  libpagemaker::PMDAllocationStats stats;
+  libpagemaker::PMDAllocationTracker::getStats(stats);
+  printAllocationStats(stats);
+
+  return 0;
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,524 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <librevenge-generators/librevenge-generators.h>
+#include <librevenge-generators/RVNGDummyDrawingGenerator.h>
+#include <librevenge-stream/librevenge-stream.h>
+
+#include <libpagemaker/libpagemaker.h>
+
+#include "PMDGenerator.h"
+
+#ifndef PACKAGE
+#define PACKAGE "libpagemaker"
+#endif
+#ifndef VERSION
+#define VERSION "UNKNOWN VERSION"
+#endif
+
+#define TOOL "pmdbench"
+
+namespace
+{
+
+enum Painter
+{
+  PAINTER_NULL,
+  PAINTER_SVG,
+  PAINTER_TEXT
+};
+
+const char *const PAINTER_NAMES[] = { "null", "svg", "text" };
+
+struct Document
+{
+  std::string m_name;
+  std::vector<unsigned char> m_data;
+  unsigned m_pages;
+  libpagemaker::PMDWorkStats m_work;
+
+  Document(const std::string &name, const std::vector<unsigned char> &data)
+    : m_name(name), m_data(data), m_pages(0), m_work()
+  { }
+};
+
+/// Fixed part of the work budget, covering the header and the table of contents.
+const unsigned long WORK_BUDGET_BASE = 65536;
+
+/// Wall times of one document (or of all of them together), in seconds.
+struct Timings
+{
+  std::vector<double> m_times;
+  double m_min;
+  double m_median;
+  double m_p99;
+
+  Timings()
+    : m_times(), m_min(0), m_median(0), m_p99(0)
+  { }
+
+  void finish()
+  {
+    std::vector<double> sorted(m_times);
+    std::sort(sorted.begin(), sorted.end());
+    const std::size_t n = sorted.size();
+    m_min = sorted.front();
+    m_median = (n % 2) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    // nearest rank
+    m_p99 = sorted[(99 * n + 99) / 100 - 1];
+  }
+};
+
+int printUsage()
+{
+  printf("`" TOOL "' measures how fast " PACKAGE " converts documents.\n");
+  printf("\n");
+  printf("Usage: " TOOL " [OPTION] [INPUT...]\n");
+  printf("\n");
+  printf("Every INPUT is a document or a directory of documents.\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("\t--painter NAME        the painter to use: null, svg or text (default: null)\n");
+  printf("\t--iterations N        number of measured runs (default: 10)\n");
+  printf("\t--warmup N            number of runs before the measurement (default: 1)\n");
+  printf("\t--output FILE         write the results to FILE instead of stdout\n");
+  printf("\t--baseline FILE       compare the results to an earlier output\n");
+  printf("\t--threshold PERCENT   slowdown of the median that counts as regression (default: 5)\n");
+  printf("\t--work-budget N       parser work units allowed per input byte (default: unlimited)\n");
+  printf("\t--generate            also measure a generated document\n");
+  printf("\t--pages N             number of pages of the generated document\n");
+  printf("\t--shapes N            number of shapes on each generated page\n");
+  printf("\t--text-length N       number of characters of each generated story\n");
+  printf("\t--polygon-points N    number of points of each generated polygon\n");
+  printf("\t--bitmap-size N       number of bytes of each generated bitmap\n");
+  printf("\t--bitmaps N           number of distinct generated bitmaps\n");
+  printf("\t--big-endian          generate a big-endian (Mac) document\n");
+  printf("\t--seed N              seed of the generated document\n");
+  printf("\t--help                show this help message\n");
+  printf("\t--version             show version information and exit\n");
+  printf("\n");
+  printf("The exit status is 2 if the comparison with the baseline found a regression\n");
+  printf("and 3 if a document exceeded the work budget; such documents are not measured.\n");
+  printf("\n");
+  printf("Report bugs to <https://bugs.documentfoundation.org/>.\n");
+  return -1;
+}
+
+int printVersion()
+{
+  printf(TOOL " " VERSION "\n");
+  return 0;
+}
+
+bool parseNumber(const char *const arg, unsigned &value)
+{
+  if (!arg || *arg < '0' || *arg > '9')
+    return false;
+  char *end = nullptr;
+  const unsigned long number = strtoul(arg, &end, 10);
+  if (*end != '\0' || number > 0xffffffffUL)
+    return false;
+  value = static_cast<unsigned>(number);
+  return true;
+}
+
+bool loadFile(const std::string &name, std::vector<unsigned char> &data)
+{
+  FILE *const file = fopen(name.c_str(), "rb");
+  if (!file)
+    return false;
+  data.clear();
+  unsigned char buffer[65536];
+  std::size_t length = 0;
+  while ((length = fread(buffer, 1, sizeof(buffer), file)) != 0)
+    data.insert(data.end(), buffer, buffer + length);
+  const bool failed = ferror(file);
+  fclose(file);
+  return !failed;
+}
+
+bool addDocument(const std::string &name, std::vector<Document> &documents)
+{
+  std::vector<unsigned char> data;
+  if (!loadFile(name, data))
+  {
+    fprintf(stderr, "ERROR: Cannot read %s\n", name.c_str());
+    return false;
+  }
+  librevenge::RVNGStringStream input(data.data(), static_cast<unsigned long>(data.size()));
+  if (!libpagemaker::PMDocument::isSupported(&input))
+  {
+    fprintf(stderr, "WARNING: Skipping unsupported file %s\n", name.c_str());
+    return true;
+  }
+  documents.push_back(Document(name, data));
+  return true;
+}
+
+/// Adds the documents of a directory, in the order of their names.
+bool addDirectory(const std::string &name, std::vector<Document> &documents)
+{
+  DIR *const dir = opendir(name.c_str());
+  if (!dir)
+  {
+    fprintf(stderr, "ERROR: Cannot read %s\n", name.c_str());
+    return false;
+  }
+  std::vector<std::string> files;
+  while (const dirent *const entry = readdir(dir))
+  {
+    const std::string path = name + "/" + entry->d_name;
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode))
+      files.push_back(path);
+  }
+  closedir(dir);
+  std::sort(files.begin(), files.end());
+
+  for (const auto &file : files)
+  {
+    if (!addDocument(file, documents))
+      return false;
+  }
+  return true;
+}
+
+bool parse(const Document &document, const Painter painter)
+{
+  librevenge::RVNGStringStream input(document.m_data.data(), static_cast<unsigned long>(document.m_data.size()));
+  libpagemaker::PMDParseOptions options;
+  switch (painter)
+  {
+  case PAINTER_SVG:
+  {
+    librevenge::RVNGStringVector output;
+    librevenge::RVNGSVGDrawingGenerator generator(output, "svg");
+    return libpagemaker::PMDocument::parse(&input, &generator, options);
+  }
+  case PAINTER_TEXT:
+  {
+    // the same as pmd2text
+    librevenge::RVNGStringVector pages;
+    librevenge::RVNGTextDrawingGenerator generator(pages);
+    options.m_content = libpagemaker::PMD_CONTENT_TEXT;
+    return libpagemaker::PMDocument::parse(&input, &generator, options);
+  }
+  default:
+  {
+    librevenge::RVNGDummyDrawingGenerator generator;
+    return libpagemaker::PMDocument::parse(&input, &generator, options);
+  }
+  }
+}
+
+/// Peak resident set size of the process, in KiB.
+long getPeakRSS()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+std::string quote(const std::string &str)
+{
+  std::string quoted("\"");
+  for (const char c : str)
+  {
+    if (c == '"' || c == '\\')
+    {
+      quoted += '\\';
+      quoted += c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", unsigned(c));
+      quoted += escaped;
+    }
+    else
+    {
+      quoted += c;
+    }
+  }
+  return quoted + "\"";
+}
+
+/**
+ * Median times of an earlier run, by document name.
+ *
+ * The total is stored under an empty name.
+ */
+typedef std::map<std::string, double> Baseline_t;
+
+bool readBaseline(const char *const file, Baseline_t &baseline)
+{
+  try
+  {
+    boost::property_tree::ptree tree;
+    boost::property_tree::read_json(file, tree);
+    for (const auto &document : tree.get_child("documents"))
+      baseline[document.second.get<std::string>("name")] = document.second.get<double>("median");
+    baseline[std::string()] = tree.get<double>("total.median");
+  }
+  catch (const boost::property_tree::ptree_error &e)
+  {
+    fprintf(stderr, "ERROR: Cannot read the baseline %s: %s\n", file, e.what());
+    return false;
+  }
+  return true;
+}
+
+/// Writes the statistics of a document and compares them to the baseline.
+bool writeTimings(FILE *const output, const Timings &timings, const unsigned long bytes, const unsigned pages, const unsigned long workUnits,
+                  const Baseline_t &baseline, const std::string &name, const double threshold)
+{
+  fprintf(output, "\"bytes\": %lu, \"pages\": %u, ", bytes, pages);
+  fprintf(output, "\"min\": %.9f, \"median\": %.9f, \"p99\": %.9f, ", timings.m_min, timings.m_median, timings.m_p99);
+  fprintf(output, "\"pagesPerSecond\": %.3f, \"mbPerSecond\": %.3f",
+          timings.m_median > 0 ? pages / timings.m_median : 0, timings.m_median > 0 ? bytes / 1e6 / timings.m_median : 0);
+  fprintf(output, ", \"workUnits\": %lu, \"workPerByte\": %.3f", workUnits, bytes > 0 ? double(workUnits) / bytes : 0);
+
+  const auto it = baseline.find(name);
+  if (it == baseline.end() || it->second <= 0)
+    return false;
+  const double change = (timings.m_median / it->second - 1) * 100;
+  const bool regression = change > threshold;
+  fprintf(output, ", \"baselineMedian\": %.9f, \"changePercent\": %.2f, \"regression\": %s", it->second, change, regression ? "true" : "false");
+  fprintf(stderr, "%-40s %12.6f %12.6f %+8.2f%%%s\n", name.empty() ? "total" : name.c_str(), it->second, timings.m_median, change, regression ? "  REGRESSION" : "");
+  return regression;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  Painter painter = PAINTER_NULL;
+  unsigned iterations = 10;
+  unsigned warmup = 1;
+  unsigned threshold = 5;
+  unsigned workBudget = 0;
+  const char *outputFile = nullptr;
+  const char *baselineFile = nullptr;
+  bool generate = false;
+  libpagemaker::PMDGeneratorOptions generatorOptions;
+  std::vector<const char *> inputs;
+
+  for (int i = 1; i < argc; i++)
+  {
+    unsigned *number = nullptr;
+    if (!strcmp(argv[i], "--painter") && i + 1 < argc)
+    {
+      const char *const name = argv[++i];
+      if (!strcmp(name, "null"))
+        painter = PAINTER_NULL;
+      else if (!strcmp(name, "svg"))
+        painter = PAINTER_SVG;
+      else if (!strcmp(name, "text"))
+        painter = PAINTER_TEXT;
+      else
+        return printUsage();
+    }
+    else if (!strcmp(argv[i], "--iterations"))
+      number = &iterations;
+    else if (!strcmp(argv[i], "--warmup"))
+      number = &warmup;
+    else if (!strcmp(argv[i], "--threshold"))
+      number = &threshold;
+    else if (!strcmp(argv[i], "--work-budget"))
+      number = &workBudget;
+    else if (!strcmp(argv[i], "--output") && i + 1 < argc)
+      outputFile = argv[++i];
+    else if (!strcmp(argv[i], "--baseline") && i + 1 < argc)
+      baselineFile = argv[++i];
+    else if (!strcmp(argv[i], "--generate"))
+      generate = true;
+    else if (!strcmp(argv[i], "--pages"))
+      number = &generatorOptions.m_pages;
+    else if (!strcmp(argv[i], "--shapes"))
+      number = &generatorOptions.m_shapesPerPage;
+    else if (!strcmp(argv[i], "--text-length"))
+      number = &generatorOptions.m_textLength;
+    else if (!strcmp(argv[i], "--polygon-points"))
+      number = &generatorOptions.m_polygonPoints;
+    else if (!strcmp(argv[i], "--bitmap-size"))
+      number = &generatorOptions.m_bitmapSize;
+    else if (!strcmp(argv[i], "--bitmaps"))
+      number = &generatorOptions.m_bitmaps;
+    else if (!strcmp(argv[i], "--seed"))
+      number = &generatorOptions.m_seed;
+    else if (!strcmp(argv[i], "--big-endian"))
+      generatorOptions.m_bigEndian = true;
+    else if (!strcmp(argv[i], "--version"))
+      return printVersion();
+    else if (strncmp(argv[i], "--", 2))
+      inputs.push_back(argv[i]);
+    else
+      return printUsage();
+
+    if (number && !parseNumber(argv[++i], *number))
+      return printUsage();
+  }
+
+  if ((inputs.empty() && !generate) || iterations == 0)
+    return printUsage();
+
+  std::vector<Document> documents;
+  for (const char *input : inputs)
+  {
+    struct stat info;
+    const bool loaded = stat(input, &info) == 0 && S_ISDIR(info.st_mode) ? addDirectory(input, documents) : addDocument(input, documents);
+    if (!loaded)
+      return 1;
+  }
+  if (generate)
+  {
+    try
+    {
+      documents.push_back(Document("generated", libpagemaker::generatePageMakerDocument(generatorOptions)));
+    }
+    catch (const std::invalid_argument &e)
+    {
+      fprintf(stderr, "ERROR: %s\n", e.what());
+      return 1;
+    }
+  }
+  if (documents.empty())
+  {
+    fprintf(stderr, "ERROR: No documents to measure\n");
+    return 1;
+  }
+
+  Baseline_t baseline;
+  if (baselineFile && !readBaseline(baselineFile, baseline))
+    return 1;
+
+  // The work does not depend on the painter, so one pass is enough. It
+  // comes first, so that documents with super-linear parsing time are
+  // stopped early instead of being measured.
+  bool workExceeded = false;
+  for (auto &document : documents)
+  {
+    librevenge::RVNGStringStream input(document.m_data.data(), static_cast<unsigned long>(document.m_data.size()));
+    libpagemaker::PMDDocumentInfo info;
+    if (libpagemaker::PMDocument::parseInfo(&input, info))
+      document.m_pages = info.m_pageCount;
+
+    input.seek(0, librevenge::RVNG_SEEK_SET);
+    librevenge::RVNGDummyDrawingGenerator generator;
+    libpagemaker::PMDParseOptions options;
+    options.m_work = &document.m_work;
+    if (workBudget != 0)
+      options.m_workBudget = workBudget * static_cast<unsigned long>(document.m_data.size()) + WORK_BUDGET_BASE;
+    libpagemaker::PMDocument::parse(&input, &generator, options);
+    if (document.m_work.m_exceeded)
+    {
+      fprintf(stderr, "ERROR: %s exceeded the work budget\n", document.m_name.c_str());
+      workExceeded = true;
+    }
+  }
+  if (workExceeded)
+    return 3;
+
+  // The documents are interleaved, so a disturbance does not hit all runs of one document.
+  std::vector<Timings> timings(documents.size());
+  Timings total;
+  for (unsigned i = 0; i != warmup + iterations; ++i)
+  {
+    double iterationTime = 0;
+    for (std::size_t k = 0; k != documents.size(); ++k)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      const bool parsed = parse(documents[k], painter);
+      const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+      if (!parsed)
+      {
+        fprintf(stderr, "ERROR: Parsing %s failed\n", documents[k].m_name.c_str());
+        return 1;
+      }
+      if (i >= warmup)
+        timings[k].m_times.push_back(time.count());
+      iterationTime += time.count();
+    }
+    if (i >= warmup)
+      total.m_times.push_back(iterationTime);
+  }
+
+  FILE *const output = outputFile ? fopen(outputFile, "w") : stdout;
+  if (!output)
+  {
+    fprintf(stderr, "ERROR: Cannot open %s for writing\n", outputFile);
+    return 1;
+  }
+
+  if (!baseline.empty())
+    fprintf(stderr, "%-40s %12s %12s %9s\n", "document", "baseline", "median", "change");
+
+  bool regression = false;
+  unsigned long totalBytes = 0;
+  unsigned totalPages = 0;
+  unsigned long totalWork = 0;
+  fprintf(output, "{\n");
+  fprintf(output, "  \"painter\": \"%s\",\n", PAINTER_NAMES[painter]);
+  fprintf(output, "  \"iterations\": %u,\n", iterations);
+  fprintf(output, "  \"warmup\": %u,\n", warmup);
+  fprintf(output, "  \"documents\": [\n");
+  for (std::size_t k = 0; k != documents.size(); ++k)
+  {
+    const Document &document = documents[k];
+    timings[k].finish();
+    totalBytes += static_cast<unsigned long>(document.m_data.size());
+    totalPages += document.m_pages;
+    totalWork += document.m_work.getWorkUnits();
+    fprintf(output, "    { \"name\": %s, ", quote(document.m_name).c_str());
+    if (writeTimings(output, timings[k], static_cast<unsigned long>(document.m_data.size()), document.m_pages, document.m_work.getWorkUnits(), baseline, document.m_name, threshold))
+      regression = true;
+    fprintf(output, " }%s\n", k + 1 != documents.size() ? "," : "");
+  }
+  fprintf(output, "  ],\n");
+  total.finish();
+  fprintf(output, "  \"total\": { ");
+  if (writeTimings(output, total, totalBytes, totalPages, totalWork, baseline, std::string(), threshold))
+    regression = true;
+  fprintf(output, " },\n");
+  fprintf(output, "  \"peakRssKiB\": %ld\n", getPeakRSS());
+  fprintf(output, "}\n");
+
+  if (outputFile)
+    fclose(output);
+
+  return regression ? 2 : 0;
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,147 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "PMDGenerator.h"
+
+#ifndef PACKAGE
+#define PACKAGE "libpagemaker"
+#endif
+#ifndef VERSION
+#define VERSION "UNKNOWN VERSION"
+#endif
+
+#define TOOL "pmdgen"
+
+namespace
+{
+
+int printUsage()
+{
+  printf("`" TOOL "' generates synthetic PageMaker documents to benchmark and fuzz " PACKAGE ".\n");
+  printf("\n");
+  printf("Usage: " TOOL " [OPTION] OUTPUT\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("\t--pages N             number of pages (default: 1)\n");
+  printf("\t--shapes N            number of shapes on each page (default: 6)\n");
+  printf("\t--text-length N       number of characters of each story (default: 60)\n");
+  printf("\t--polygon-points N    number of points of each polygon (default: 7)\n");
+  printf("\t--bitmap-size N       number of bytes of each bitmap (default: 300)\n");
+  printf("\t--bitmaps N           number of distinct bitmaps (default: 1)\n");
+  printf("\t--big-endian          write a big-endian (Mac) document\n");
+  printf("\t--double-sided        write a double-sided document\n");
+  printf("\t--seed N              seed of the random shape properties (default: 1)\n");
+  printf("\t--help                show this help message\n");
+  printf("\t--version             show version information and exit\n");
+  printf("\n");
+  printf("Report bugs to <https://bugs.documentfoundation.org/>.\n");
+  return -1;
+}
+
+int printVersion()
+{
+  printf(TOOL " " VERSION "\n");
+  return 0;
+}
+
+bool parseNumber(const char *const arg, unsigned &value)
+{
+  if (!arg || *arg < '0' || *arg > '9')
+    return false;
+  char *end = nullptr;
+  const unsigned long number = strtoul(arg, &end, 10);
+  if (*end != '\0' || number > 0xffffffffUL)
+    return false;
+  value = static_cast<unsigned>(number);
+  return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  libpagemaker::PMDGeneratorOptions options;
+  char *file = nullptr;
+
+  if (argc < 2)
+    return printUsage();
+
+  for (int i = 1; i < argc; i++)
+  {
+    unsigned *number = nullptr;
+    if (!strcmp(argv[i], "--pages"))
+      number = &options.m_pages;
+    else if (!strcmp(argv[i], "--shapes"))
+      number = &options.m_shapesPerPage;
+    else if (!strcmp(argv[i], "--text-length"))
+      number = &options.m_textLength;
+    else if (!strcmp(argv[i], "--polygon-points"))
+      number = &options.m_polygonPoints;
+    else if (!strcmp(argv[i], "--bitmap-size"))
+      number = &options.m_bitmapSize;
+    else if (!strcmp(argv[i], "--bitmaps"))
+      number = &options.m_bitmaps;
+    else if (!strcmp(argv[i], "--seed"))
+      number = &options.m_seed;
+    else if (!strcmp(argv[i], "--big-endian"))
+      options.m_bigEndian = true;
+    else if (!strcmp(argv[i], "--double-sided"))
+      options.m_doubleSided = true;
+    else if (!strcmp(argv[i], "--version"))
+      return printVersion();
+    else if (!file && strncmp(argv[i], "--", 2))
+      file = argv[i];
+    else
+      return printUsage();
+
+    if (number && !parseNumber(argv[++i], *number))
+      return printUsage();
+  }
+
+  if (!file)
+    return printUsage();
+
+  std::vector<unsigned char> document;
+  try
+  {
+    document = libpagemaker::generatePageMakerDocument(options);
+  }
+  catch (const std::invalid_argument &e)
+  {
+    fprintf(stderr, "ERROR: %s\n", e.what());
+    return 1;
+  }
+
+  FILE *const output = fopen(file, "wb");
+  if (!output)
+  {
+    fprintf(stderr, "ERROR: Cannot open %s for writing\n", file);
+    return 1;
+  }
+  const bool written = fwrite(document.data(), 1, document.size(), output) == document.size();
+  if (fclose(output) != 0 || !written)
+  {
+    fprintf(stderr, "ERROR: Cannot write %s\n", file);
+    return 1;
+  }
+
+  return 0;
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
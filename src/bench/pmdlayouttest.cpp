@@ -0,0 +1,102 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/*
+ * Checks the record layouts against hand-written record bytes. The
+ * generator writes through the same field descriptors, so it cannot
+ * find a wrong offset.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "PMDRecord.h"
+#include "PMDRecordLayout.h"
+
+using namespace libpagemaker;
+
+namespace
+{
+
+unsigned failures = 0;
+
+void check(const bool condition, const char *const what)
+{
+  if (!condition)
+  {
+    fprintf(stderr, "FAIL: %s\n", what);
+    ++failures;
+  }
+}
+
+/// Writes a set paragraph rule the way PageMaker stores it: 18 bytes.
+void writeRule(unsigned char *const p, const bool bigEndian, const uint8_t type, const uint8_t width,
+               const uint8_t color, const uint8_t tint)
+{
+  memset(p, 0, 18);
+  p[bigEndian ? 1 : 0] = 0x1; // flags
+  p[2] = type;
+  // width is a 24.8 fixed point number
+  p[bigEndian ? 2 + 4 : 1 + 4] = width;
+  p[bigEndian ? 9 : 8] = color;
+  p[bigEndian ? 11 : 10] = tint;
+}
+
+template<typename Endian>
+void checkParaRules()
+{
+  unsigned char data[PARA_RECORD_SIZE];
+  memset(data, 0, sizeof(data));
+
+  // both rules set: the rule below directly follows the rule above
+  writeRule(data + 0x2c, Endian::IS_BIG, 1, 2, 3, 4);
+  writeRule(data + 0x3e, Endian::IS_BIG, 5, 6, 7, 8);
+  const PMDRecordView<Endian> record(data, sizeof(data));
+
+  const boost::optional<PMDStrokeProperties> above = record.get(ParaRecord::RULE_ABOVE);
+  check(bool(above), "rule above is set");
+  if (above)
+  {
+    check(above->m_strokeType == 1, "type of rule above");
+    check(above->m_strokeWidth == 2, "width of rule above");
+    check(above->m_strokeColor == 3, "color of rule above");
+    check(above->m_strokeTint == 4, "tint of rule above");
+  }
+
+  const boost::optional<PMDStrokeProperties> below = record.get(ParaRecord::RULE_BELOW);
+  check(bool(below), "rule below is set");
+  if (below)
+  {
+    check(below->m_strokeType == 5, "type of rule below");
+    check(below->m_strokeWidth == 6, "width of rule below");
+    check(below->m_strokeColor == 7, "color of rule below");
+    check(below->m_strokeTint == 8, "tint of rule below");
+  }
+
+  // the rule below ends the record
+  check(0x3e + PMDFieldTraits<boost::optional<PMDStrokeProperties> >::SIZE == PARA_RECORD_SIZE, "rule below ends the record");
+
+  memset(data + 0x2c, 0, 18);
+  check(!record.get(ParaRecord::RULE_ABOVE), "unset rule above");
+  check(bool(record.get(ParaRecord::RULE_BELOW)), "rule below without rule above");
+}
+
+}
+
+int main()
+{
+  checkParaRules<PMDLittleEndian>();
+  checkParaRules<PMDBigEndian>();
+
+  if (failures != 0)
+    fprintf(stderr, "%u checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
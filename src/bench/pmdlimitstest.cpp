@@ -0,0 +1,122 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/*
+ * Checks that the resource limits stop parsing with the right error,
+ * also while the table of contents is being read.
+ */
+
+#include <stdio.h>
+
+#include <librevenge-generators/RVNGDummyDrawingGenerator.h>
+#include <librevenge-stream/librevenge-stream.h>
+
+#include <libpagemaker/libpagemaker.h>
+
+#include "PMDGenerator.h"
+
+using namespace libpagemaker;
+
+namespace
+{
+
+unsigned failures = 0;
+
+void check(const bool condition, const char *const what)
+{
+  if (!condition)
+  {
+    fprintf(stderr, "FAIL: %s\n", what);
+    ++failures;
+  }
+}
+
+/// Remembers whether the table of contents has been read completely.
+class ToCProgress : public PMDProgress
+{
+public:
+  bool m_tocRead;
+
+  ToCProgress()
+    : PMDProgress(), m_tocRead(false)
+  { }
+
+  bool tableOfContentsRead() override
+  {
+    m_tocRead = true;
+    return true;
+  }
+};
+
+struct Result
+{
+  bool m_parsed;
+  PMDParseError m_error;
+  bool m_tocRead;
+  PMDWorkStats m_work;
+
+  Result()
+    : m_parsed(false), m_error(PMD_ERROR_NONE), m_tocRead(false), m_work()
+  { }
+};
+
+Result parse(const std::vector<unsigned char> &document, PMDParseOptions options)
+{
+  Result result;
+  ToCProgress progress;
+  options.m_error = &result.m_error;
+  options.m_progress = &progress;
+  options.m_work = &result.m_work;
+
+  librevenge::RVNGStringStream input(document.data(), static_cast<unsigned long>(document.size()));
+  librevenge::RVNGDummyDrawingGenerator painter;
+  result.m_parsed = PMDocument::parse(&input, &painter, options);
+  result.m_tocRead = progress.m_tocRead;
+  return result;
+}
+
+}
+
+int main()
+{
+  PMDGeneratorOptions generatorOptions;
+  generatorOptions.m_pages = 4;
+  const std::vector<unsigned char> document = generatePageMakerDocument(generatorOptions);
+
+  const Result unlimited = parse(document, PMDParseOptions());
+  check(unlimited.m_parsed && unlimited.m_error == PMD_ERROR_NONE, "parsing without limits succeeds");
+  check(unlimited.m_tocRead, "the table of contents is read");
+
+  // Every entry of the table of contents is a record visit.
+  PMDParseOptions recordOptions;
+  recordOptions.m_maxRecords = 3;
+  const Result records = parse(document, recordOptions);
+  check(!records.m_parsed && records.m_error == PMD_ERROR_RECORD_LIMIT, "record limit in the table of contents");
+  check(!records.m_tocRead, "record limit stops reading the table of contents");
+
+  PMDParseOptions workOptions;
+  workOptions.m_workBudget = 10;
+  const Result work = parse(document, workOptions);
+  check(!work.m_parsed && work.m_error == PMD_ERROR_WORK_BUDGET, "work budget in the table of contents");
+  check(work.m_work.m_exceeded, "work budget is reported as exceeded");
+  check(!work.m_tocRead, "work budget stops reading the table of contents");
+
+  // Past the table of contents, the limits still apply.
+  PMDParseOptions laterOptions;
+  laterOptions.m_maxRecords = unlimited.m_work.m_records - 1;
+  const Result later = parse(document, laterOptions);
+  check(!later.m_parsed && later.m_error == PMD_ERROR_RECORD_LIMIT, "record limit after the table of contents");
+  check(later.m_tocRead, "the table of contents is read before the record limit is hit");
+
+  if (failures != 0)
+    fprintf(stderr, "%u checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
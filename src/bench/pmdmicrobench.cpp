@@ -0,0 +1,467 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <librevenge-stream/librevenge-stream.h>
+
+#include "OutputShape.h"
+#include "PMDByteReader.h"
+#include "PMDCollector.h"
+#include "PMDGenerator.h"
+#include "PMDParser.h"
+#include "constants.h"
+#include "libpagemaker_utils.h"
+
+#ifndef PACKAGE
+#define PACKAGE "libpagemaker"
+#endif
+#ifndef VERSION
+#define VERSION "UNKNOWN VERSION"
+#endif
+
+#define TOOL "pmdmicrobench"
+
+using namespace libpagemaker;
+
+namespace
+{
+
+// Results are accumulated here, so the compiler cannot drop the measured code.
+volatile unsigned long g_sink = 0;
+
+/// Counts the instructions retired by this thread in user space, if the system allows it.
+class InstructionCounter
+{
+  int m_fd;
+
+  /* Prevent copy and assignment */
+  InstructionCounter &operator=(const InstructionCounter &);
+  InstructionCounter(const InstructionCounter &);
+
+public:
+  InstructionCounter()
+    : m_fd(-1)
+  {
+#ifdef __linux__
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    m_fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+
+  ~InstructionCounter()
+  {
+#ifdef __linux__
+    if (m_fd >= 0)
+      close(m_fd);
+#endif
+  }
+
+  bool isAvailable() const
+  {
+    return m_fd >= 0;
+  }
+
+  void start()
+  {
+#ifdef __linux__
+    if (m_fd >= 0)
+    {
+      ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  uint64_t stop()
+  {
+    uint64_t count = 0;
+#ifdef __linux__
+    if (m_fd >= 0)
+    {
+      ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+      if (read(m_fd, &count, sizeof(count)) != sizeof(count))
+        count = 0;
+    }
+#endif
+    return count;
+  }
+};
+
+/**
+ * Runs the benchmarks and prints their results.
+ *
+ * A benchmark is a function that does some operations and returns
+ * their number. It is called repeatedly until the minimal time is
+ * reached. The optional set-up function runs before each call, but
+ * is not measured.
+ */
+class BenchmarkRunner
+{
+  const double m_minTime;
+  const char *const m_filter;
+  InstructionCounter m_counter;
+
+  /* Prevent copy and assignment */
+  BenchmarkRunner &operator=(const BenchmarkRunner &);
+  BenchmarkRunner(const BenchmarkRunner &);
+
+public:
+  BenchmarkRunner(const double minTime, const char *const filter)
+    : m_minTime(minTime), m_filter(filter), m_counter()
+  {
+    printf("%-40s %12s %14s\n", "benchmark", "ns/op", "instructions/op");
+  }
+
+  void run(const std::string &name, const std::function<unsigned long()> &benchmark,
+           const std::function<void()> &setUp = std::function<void()>())
+  {
+    if (m_filter && name.find(m_filter) == std::string::npos)
+      return;
+
+    // warm-up
+    if (setUp)
+      setUp();
+    benchmark();
+
+    double seconds = 0;
+    uint64_t instructions = 0;
+    unsigned long ops = 0;
+    while (seconds < m_minTime)
+    {
+      if (setUp)
+        setUp();
+      const auto start = std::chrono::steady_clock::now();
+      m_counter.start();
+      ops += benchmark();
+      instructions += m_counter.stop();
+      const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+      seconds += time.count();
+    }
+
+    if (ops == 0)
+      return;
+    printf("%-40s %12.2f", name.c_str(), seconds * 1e9 / ops);
+    if (m_counter.isAvailable())
+      printf(" %14.1f\n", double(instructions) / ops);
+    else
+      printf(" %14s\n", "n/a");
+  }
+};
+
+/// A generated PageMaker stream, parsed into a fresh collector.
+class ParsedDocument
+{
+  std::vector<unsigned> m_shapesSeqNums;
+  std::vector<unsigned char> m_data;
+  std::unique_ptr<librevenge::RVNGStringStream> m_input;
+  std::unique_ptr<PMDCollector> m_collector;
+  std::unique_ptr<PMDParser> m_parser;
+
+  /* Prevent copy and assignment */
+  ParsedDocument &operator=(const ParsedDocument &);
+  ParsedDocument(const ParsedDocument &);
+
+public:
+  explicit ParsedDocument(const PMDGeneratorOptions &options)
+    : m_shapesSeqNums(), m_data(generatePageMakerStream(options, &m_shapesSeqNums)), m_input(), m_collector(), m_parser()
+  {
+    reset();
+  }
+
+  void reset()
+  {
+    m_parser.reset();
+    m_input.reset(new librevenge::RVNGStringStream(m_data.data(), static_cast<unsigned long>(m_data.size())));
+    m_collector.reset(new PMDCollector());
+    m_parser.reset(new PMDParser(m_input.get(), m_collector.get(), PMDParseOptions()));
+    m_parser->parse();
+  }
+
+  PMDParser &getParser()
+  {
+    return *m_parser;
+  }
+
+  const PMDCollector &getCollector() const
+  {
+    return *m_collector;
+  }
+
+  uint16_t getShapesSeqNum() const
+  {
+    return static_cast<uint16_t>(m_shapesSeqNums.front());
+  }
+
+  /// The shapes of the last page are the last entry of the ToC.
+  unsigned getToCLength() const
+  {
+    return m_shapesSeqNums.back() + 1;
+  }
+};
+
+const unsigned STREAM_LENGTH = 1 << 20;
+const unsigned SEEKS = 4096;
+const unsigned BLOCK = 16;
+
+template<typename Input>
+void runStreamBenchmarks(BenchmarkRunner &runner, const std::string &prefix, Input &input, const std::vector<unsigned long> &positions)
+{
+  runner.run(prefix + "readU8", [&]()
+  {
+    seek(input, 0);
+    unsigned long sum = 0;
+    for (unsigned i = 0; i != STREAM_LENGTH; ++i)
+      sum += readU8(input);
+    g_sink += sum;
+    return (unsigned long) STREAM_LENGTH;
+  });
+  runner.run(prefix + "readU16", [&]()
+  {
+    seek(input, 0);
+    unsigned long sum = 0;
+    for (unsigned i = 0; i != STREAM_LENGTH / 2; ++i)
+      sum += readU16(input, true);
+    g_sink += sum;
+    return (unsigned long) STREAM_LENGTH / 2;
+  });
+  runner.run(prefix + "readU32", [&]()
+  {
+    seek(input, 0);
+    unsigned long sum = 0;
+    for (unsigned i = 0; i != STREAM_LENGTH / 4; ++i)
+      sum += readU32(input, true);
+    g_sink += sum;
+    return (unsigned long) STREAM_LENGTH / 4;
+  });
+  runner.run(prefix + "readNBytes", [&]()
+  {
+    seek(input, 0);
+    unsigned long sum = 0;
+    for (unsigned i = 0; i != STREAM_LENGTH / BLOCK; ++i)
+      sum += readNBytes(input, BLOCK)[BLOCK - 1];
+    g_sink += sum;
+    return (unsigned long) STREAM_LENGTH / BLOCK;
+  });
+  runner.run(prefix + "skip", [&]()
+  {
+    seek(input, 0);
+    for (unsigned i = 0; i != STREAM_LENGTH / BLOCK; ++i)
+      skip(input, BLOCK);
+    return (unsigned long) STREAM_LENGTH / BLOCK;
+  });
+  runner.run(prefix + "seek", [&]()
+  {
+    for (const unsigned long pos : positions)
+      seek(input, pos);
+    return (unsigned long) positions.size();
+  });
+}
+
+void runStreamBenchmarks(BenchmarkRunner &runner, const char *const tmpDir)
+{
+  std::mt19937 random(1);
+  std::vector<unsigned char> data(STREAM_LENGTH);
+  for (auto &byte : data)
+    byte = static_cast<unsigned char>(random());
+  std::vector<unsigned long> positions(SEEKS);
+  for (auto &pos : positions)
+    pos = random() % STREAM_LENGTH;
+
+  RVNGInputStreamPtr stringStream(new librevenge::RVNGStringStream(data.data(), STREAM_LENGTH));
+  runStreamBenchmarks(runner, "string-stream/", stringStream, positions);
+
+  const std::string fileName = std::string(tmpDir) + "/" TOOL ".tmp";
+  FILE *const file = fopen(fileName.c_str(), "wb");
+  if (file && fwrite(data.data(), 1, data.size(), file) == data.size() && fclose(file) == 0)
+  {
+    RVNGInputStreamPtr fileStream(new librevenge::RVNGFileStream(fileName.c_str()));
+    runStreamBenchmarks(runner, "file-stream/", fileStream, positions);
+  }
+  else
+  {
+    if (file)
+      fclose(file);
+    fprintf(stderr, "WARNING: Cannot write %s; skipping the file stream benchmarks\n", fileName.c_str());
+  }
+  remove(fileName.c_str());
+
+  PMDByteReader reader(data);
+  runStreamBenchmarks(runner, "byte-reader/", reader, positions);
+}
+
+struct ShapeKind
+{
+  const char *m_name;
+  uint8_t m_type;
+};
+
+const ShapeKind SHAPE_KINDS[] =
+{
+  { "line", LINE_RECORD },
+  { "rectangle", RECTANGLE_RECORD },
+  { "ellipse", ELLIPSE_RECORD },
+  { "polygon", POLYGON_RECORD },
+  { "text", TEXT_RECORD },
+  { "bitmap", BITMAP_RECORD }
+};
+
+const unsigned SHAPES = 256;
+const unsigned DECODE_REPEATS = 16;
+
+void runShapeBenchmarks(BenchmarkRunner &runner)
+{
+  for (const auto &kind : SHAPE_KINDS)
+  {
+    PMDGeneratorOptions options;
+    options.m_shapesPerPage = SHAPES;
+    options.m_shapeType = kind.m_type;
+    ParsedDocument document(options);
+
+    // A new collector for every run, so the shapes do not pile up.
+    runner.run(std::string("decode/") + kind.m_name, [&]()
+    {
+      for (unsigned i = 0; i != DECODE_REPEATS; ++i)
+        document.getParser().reparseShapes(document.getShapesSeqNum(), 0);
+      return (unsigned long) SHAPES * DECODE_REPEATS;
+    }, [&]()
+    {
+      document.reset();
+    });
+
+    document.reset();
+    const PMDPage &page = document.getCollector().getPage(0);
+    runner.run(std::string("newOutputShape/") + kind.m_name, [&]()
+    {
+      unsigned long sum = 0;
+      for (unsigned i = 0; i != page.numShapes(); ++i)
+        sum += newOutputShape(page.getShape(i), InchPoint(0, 0))->numPoints();
+      g_sink += sum;
+      return (unsigned long) page.numShapes();
+    });
+  }
+}
+
+void runRecordLookupBenchmarks(BenchmarkRunner &runner)
+{
+  for (unsigned pages = 1; pages <= 16384; pages *= 16)
+  {
+    PMDGeneratorOptions options;
+    options.m_pages = pages;
+    options.m_shapesPerPage = 1;
+    ParsedDocument document(options);
+    const unsigned records = document.getToCLength();
+
+    runner.run("record-lookup/toc-" + std::to_string(records), [&]()
+    {
+      unsigned long sum = 0;
+      for (unsigned seqNum = 0; seqNum != records; ++seqNum)
+        sum += document.getParser().countRecordContainers(static_cast<uint16_t>(seqNum));
+      g_sink += sum;
+      return (unsigned long) records;
+    });
+  }
+}
+
+int printUsage()
+{
+  printf("`" TOOL "' measures the hot primitives of " PACKAGE " in isolation.\n");
+  printf("\n");
+  printf("Usage: " TOOL " [OPTION]\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("\t--filter TEXT         only run the benchmarks whose names contain TEXT\n");
+  printf("\t--min-time MS         minimal measured time of each benchmark (default: 200)\n");
+  printf("\t--tmp-dir DIR         directory for the file stream benchmarks (default: /tmp)\n");
+  printf("\t--help                show this help message\n");
+  printf("\t--version             show version information and exit\n");
+  printf("\n");
+  printf("Instruction counts need perf_event_open(2); they are n/a if it is not permitted.\n");
+  printf("\n");
+  printf("Report bugs to <https://bugs.documentfoundation.org/>.\n");
+  return -1;
+}
+
+int printVersion()
+{
+  printf(TOOL " " VERSION "\n");
+  return 0;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+  const char *filter = nullptr;
+  const char *tmpDir = "/tmp";
+  double minTime = 0.2;
+
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+      filter = argv[++i];
+    else if (!strcmp(argv[i], "--min-time") && i + 1 < argc)
+      minTime = atoi(argv[++i]) / 1000.0;
+    else if (!strcmp(argv[i], "--tmp-dir") && i + 1 < argc)
+      tmpDir = argv[++i];
+    else if (!strcmp(argv[i], "--version"))
+      return printVersion();
+    else
+      return printUsage();
+  }
+
+  BenchmarkRunner runner(minTime, filter);
+  try
+  {
+    runStreamBenchmarks(runner, tmpDir);
+    runShapeBenchmarks(runner);
+    runRecordLookupBenchmarks(runner);
+  }
+  catch (const std::exception &e)
+  {
+    fprintf(stderr, "ERROR: %s\n", e.what());
+    return 1;
+  }
+  catch (...)
+  {
+    fprintf(stderr, "ERROR: Parsing a generated document failed\n");
+    return 1;
+  }
+
+  return 0;
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
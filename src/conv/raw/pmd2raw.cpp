@@ -39,6 +39,8 @@ int printUsage()
   printf("\n");
   printf("Options:\n");
   printf("\t--callgraph           display the call graph nesting level\n");
+  printf("\t--io-stats            print accesses to the input file to stderr\n");
+  printf("\t--stats               print timings of the parsing phases to stderr\n");
   printf("\t--help                show this help message\n");
   printf("\t--version             show version information and exit\n");
   printf("\n");
@@ -52,11 +54,40 @@ int printVersion()
   return 0;
 }
 
+void printStats(const libpagemaker::PMDParseStats &stats)
+{
+  if (!stats.m_available)
+  {
+    fprintf(stderr, "Statistics are not available; configure " PACKAGE " with --enable-stats.\n");
+    return;
+  }
+  fprintf(stderr, "%-20s %10s %12s\n", "phase", "count", "seconds");
+  for (unsigned i = 0; i != libpagemaker::PMD_PHASE_COUNT; ++i)
+  {
+    const libpagemaker::PMDPhaseStats &phase = stats.m_phases[i];
+    if (phase.m_count != 0)
+      fprintf(stderr, "%-20s %10lu %12.6f\n", libpagemaker::PMDParseStats::getPhaseName(libpagemaker::PMDStatsPhase(i)), phase.m_count, phase.m_seconds);
+  }
+}
+
+void printStreamStats(const libpagemaker::PMDStreamStats &stats)
+{
+  fprintf(stderr, "%-8s %10s %12s %10s %10s %14s\n", "phase", "reads", "bytes", "seeks", "backward", "seek distance");
+  for (unsigned i = 0; i != libpagemaker::PMD_STREAM_PHASE_COUNT; ++i)
+  {
+    const libpagemaker::PMDStreamPhaseStats &phase = stats.m_phases[i];
+    fprintf(stderr, "%-8s %10lu %12lu %10lu %10lu %14lu\n", libpagemaker::PMDStreamStats::getPhaseName(libpagemaker::PMDStreamPhase(i)),
+            phase.m_reads, phase.m_bytesRead, phase.m_seeks, phase.m_backwardSeeks, phase.m_seekDistance);
+  }
+}
+
 } // anonymous namespace
 
 int main(int argc, char *argv[])
 {
   bool printIndentLevel = false;
+  bool printStatistics = false;
+  bool printStreamStatistics = false;
   char *file = nullptr;
 
   if (argc < 2)
@@ -66,6 +97,10 @@ int main(int argc, char *argv[])
   {
     if (!strcmp(argv[i], "--callgraph"))
       printIndentLevel = true;
+    else if (!strcmp(argv[i], "--io-stats"))
+      printStreamStatistics = true;
+    else if (!strcmp(argv[i], "--stats"))
+      printStatistics = true;
     else if (!strcmp(argv[i], "--version"))
       return printVersion();
     else if (!file && strncmp(argv[i], "--", 2))
@@ -86,9 +121,21 @@ int main(int argc, char *argv[])
   }
 
   librevenge::RVNGRawDrawingGenerator painter(printIndentLevel);
-  if (!libpagemaker::PMDocument::parse(&input, &painter))
+  libpagemaker::PMDParseStats stats;
+  libpagemaker::PMDStreamStats streamStats;
+  libpagemaker::PMDParseOptions options;
+  if (printStatistics)
+    options.m_stats = &stats;
+  if (printStreamStatistics)
+    options.m_streamStats = &streamStats;
+  if (!libpagemaker::PMDocument::parse(&input, &painter, options))
     return 1;
 
+  if (printStatistics)
+    printStats(stats);
+  if (printStreamStatistics)
+    printStreamStats(streamStats);
+
   return 0;
 }
 
@@ -11,6 +11,7 @@
 #include "config.h"
 #endif
 
+#include <iomanip>
 #include <iostream>
 #include <stdio.h>
 #include <string.h>
@@ -36,6 +37,7 @@ int printUsage()
   printf("Usage: " TOOL " [OPTION] INPUT\n");
   printf("\n");
   printf("Options:\n");
+  printf("\t--stats               print timings of the parsing phases to stderr\n");
   printf("\t--help                show this help message\n");
   printf("\t--version             show version information and exit\n");
   printf("\n");
@@ -49,6 +51,24 @@ int printVersion()
   return 0;
 }
 
+void printStats(const libpagemaker::PMDParseStats &stats)
+{
+  if (!stats.m_available)
+  {
+    std::cerr << "Statistics are not available; configure libpagemaker with --enable-stats." << std::endl;
+    return;
+  }
+  std::cerr << std::left << std::setw(20) << "phase" << std::right << std::setw(11) << "count" << std::setw(13) << "seconds" << std::endl;
+  std::cerr << std::fixed << std::setprecision(6);
+  for (unsigned i = 0; i != libpagemaker::PMD_PHASE_COUNT; ++i)
+  {
+    const libpagemaker::PMDPhaseStats &phase = stats.m_phases[i];
+    if (phase.m_count != 0)
+      std::cerr << std::left << std::setw(20) << libpagemaker::PMDParseStats::getPhaseName(libpagemaker::PMDStatsPhase(i))
+                << std::right << std::setw(11) << phase.m_count << std::setw(13) << phase.m_seconds << std::endl;
+  }
+}
+
 } // anonymous namespace
 
 int main(int argc, char *argv[])
@@ -56,11 +76,14 @@ int main(int argc, char *argv[])
   if (argc < 2)
     return printUsage();
 
+  bool printStatistics = false;
   char *file = nullptr;
 
   for (int i = 1; i < argc; i++)
   {
-    if (!strcmp(argv[i], "--version"))
+    if (!strcmp(argv[i], "--stats"))
+      printStatistics = true;
+    else if (!strcmp(argv[i], "--version"))
       return printVersion();
     else if (!file && strncmp(argv[i], "--", 2))
       file = argv[i];
@@ -81,7 +104,11 @@ int main(int argc, char *argv[])
 
   librevenge::RVNGStringVector output;
   librevenge::RVNGSVGDrawingGenerator generator(output, "svg");
-  if (!libpagemaker::PMDocument::parse(&input, &generator))
+  libpagemaker::PMDParseStats stats;
+  libpagemaker::PMDParseOptions options;
+  if (printStatistics)
+    options.m_stats = &stats;
+  if (!libpagemaker::PMDocument::parse(&input, &generator, options))
   {
     std::cerr << "ERROR: SVG Generation failed!" << std::endl;
     return 1;
@@ -116,6 +143,9 @@ int main(int argc, char *argv[])
   std::cout << "</body>" << std::endl;
   std::cout << "</html>" << std::endl;
 
+  if (printStatistics)
+    printStats(stats);
+
   return 0;
 }
 
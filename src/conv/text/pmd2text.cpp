@@ -38,6 +38,7 @@ int printUsage()
   printf("Usage: " TOOL " [OPTION] INPUT\n");
   printf("\n");
   printf("Options:\n");
+  printf("\t--stats               print timings of the parsing phases to stderr\n");
   printf("\t--help                show this help message\n");
   printf("\t--version             show version information and exit\n");
   printf("\n");
@@ -51,10 +52,27 @@ int printVersion()
   return 0;
 }
 
+void printStats(const libpagemaker::PMDParseStats &stats)
+{
+  if (!stats.m_available)
+  {
+    fprintf(stderr, "Statistics are not available; configure " PACKAGE " with --enable-stats.\n");
+    return;
+  }
+  fprintf(stderr, "%-20s %10s %12s\n", "phase", "count", "seconds");
+  for (unsigned i = 0; i != libpagemaker::PMD_PHASE_COUNT; ++i)
+  {
+    const libpagemaker::PMDPhaseStats &phase = stats.m_phases[i];
+    if (phase.m_count != 0)
+      fprintf(stderr, "%-20s %10lu %12.6f\n", libpagemaker::PMDParseStats::getPhaseName(libpagemaker::PMDStatsPhase(i)), phase.m_count, phase.m_seconds);
+  }
+}
+
 } // anonymous namespace
 
 int main(int argc, char *argv[])
 {
+  bool printStatistics = false;
   char *file = nullptr;
 
   if (argc < 2)
@@ -62,7 +80,9 @@ int main(int argc, char *argv[])
 
   for (int i = 1; i < argc; i++)
   {
-    if (!strcmp(argv[i], "--version"))
+    if (!strcmp(argv[i], "--stats"))
+      printStatistics = true;
+    else if (!strcmp(argv[i], "--version"))
       return printVersion();
     else if (!file && strncmp(argv[i], "--", 2))
       file = argv[i];
@@ -83,7 +103,12 @@ int main(int argc, char *argv[])
 
   librevenge::RVNGStringVector pages;
   librevenge::RVNGTextDrawingGenerator painter(pages);
-  if (!libpagemaker::PMDocument::parse(&input, &painter))
+  libpagemaker::PMDParseStats stats;
+  libpagemaker::PMDParseOptions options;
+  options.m_content = libpagemaker::PMD_CONTENT_TEXT;
+  if (printStatistics)
+    options.m_stats = &stats;
+  if (!libpagemaker::PMDocument::parse(&input, &painter, options))
     return 1;
 
   for (unsigned i = 0; i != pages.size(); ++i)
@@ -92,6 +117,9 @@ int main(int argc, char *argv[])
     puts("\n");
   }
 
+  if (printStatistics)
+    printStats(stats);
+
   return 0;
 }
 
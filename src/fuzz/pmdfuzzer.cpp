@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 
 #include <libpagemaker/libpagemaker.h>
 
@@ -16,11 +17,39 @@
 
 #include <librevenge-stream/librevenge-stream.h>
 
+namespace
+{
+
+// Work units allowed per input byte, from PMD_FUZZ_WORK_BUDGET. Inputs
+// that need more are reported as crashes, so that the fuzzer keeps them
+// as reproducers of super-linear parsing. 0 disables the check.
+unsigned long getWorkBudgetPerByte()
+{
+  const char *const budget = std::getenv("PMD_FUZZ_WORK_BUDGET");
+  return budget ? std::strtoul(budget, nullptr, 10) : 0;
+}
+
+// Fixed part of the budget, covering the header and the table of contents.
+const unsigned long WORK_BUDGET_BASE = 65536;
+
+}
+
 extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
 {
+  static const unsigned long workBudgetPerByte = getWorkBudgetPerByte();
+
   librevenge::RVNGStringStream input(data, size);
   librevenge::RVNGDummyDrawingGenerator generator;
-  libpagemaker::PMDocument::parse(&input, &generator);
+  libpagemaker::PMDParseOptions options;
+  libpagemaker::PMDWorkStats work;
+  if (workBudgetPerByte != 0)
+  {
+    options.m_work = &work;
+    options.m_workBudget = workBudgetPerByte * size + WORK_BUDGET_BASE;
+  }
+  libpagemaker::PMDocument::parse(&input, &generator, options);
+  if (work.m_exceeded)
+    std::abort();
   return 0;
 }
 
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <math.h>
 
+#include "PMDAllocationScope.h"
 #include "Units.h"
 #include "constants.h"
 #include "geometry.h"
@@ -19,11 +20,12 @@
 std::shared_ptr<libpagemaker::OutputShape> libpagemaker::newOutputShape(
   const std::shared_ptr<const PMDLineSet> &ptrToLineSet, const InchPoint &translate)
 {
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_LAYOUT, getAllocationShape(ptrToLineSet->shapeType()));
   if (ptrToLineSet->shapeType() == SHAPE_TYPE_TEXTBOX)
   {
 
     std::shared_ptr<libpagemaker::OutputShape> ptrToOutputShape(
-      new OutputShape(ptrToLineSet->getIsClosed(), ptrToLineSet->shapeType(), ptrToLineSet->getRotation(), ptrToLineSet->getSkew(), ptrToLineSet->getText(), ptrToLineSet->getCharProperties(), ptrToLineSet->getParaProperties()));
+      new OutputShape(ptrToLineSet->getIsClosed(), ptrToLineSet->shapeType(), ptrToLineSet->getRotation(), ptrToLineSet->getSkew(), ptrToLineSet->getStory()));
 
     PMDShapePoint bboxTopLeft = ptrToLineSet->getBboxTopLeft();
     PMDShapePoint bboxBotRight = ptrToLineSet->getBboxBotRight();
@@ -116,12 +118,7 @@ std::shared_ptr<libpagemaker::OutputShape> libpagemaker::newOutputShape(
       double pmdSkew = ptrToLineSet->getSkew();
       if (pmdRotation == 0 && pmdSkew == 0)
       {
-        for (auto &pmdPoint : pmdPoints)
-        {
-          double x = pmdPoint.m_x.toInches() + translate.m_x;
-          double y = pmdPoint.m_y.toInches() + translate.m_y;
-          ptrToOutputShape->addPoint(InchPoint(x, y));
-        }
+        ptrToOutputShape->addPoints(pmdPoints, translate);
       }
       else
       {
@@ -162,12 +159,16 @@ std::shared_ptr<libpagemaker::OutputShape> libpagemaker::newOutputShape(
           double tx = (bboxBotRight.m_x.toInches() + bboxTopLeft.m_x.toInches())/2 + translate.m_x;
           double ty = (bboxBotRight.m_y.toInches() + bboxTopLeft.m_y.toInches())/2 + translate.m_y;
 
+          const double tanSkew = tan(pmdSkew);
+          const double cosRotation = cos(pmdRotation);
+          const double sinRotation = sin(pmdRotation);
+
           for (auto &pmdPoint : pmdPoints)
           {
 
-            double temp = pmdPoint.m_x.toInches() + tan(pmdSkew)*pmdPoint.m_y.toInches();
-            double  x = temp*cos(pmdRotation) - pmdPoint.m_y.toInches()*sin(pmdRotation) + tx;
-            double  y = temp*sin(pmdRotation) + pmdPoint.m_y.toInches()*cos(pmdRotation) + ty;
+            double temp = pmdPoint.m_x.toInches() + tanSkew*pmdPoint.m_y.toInches();
+            double  x = temp*cosRotation - pmdPoint.m_y.toInches()*sinRotation + tx;
+            double  y = temp*sinRotation + pmdPoint.m_y.toInches()*cosRotation + ty;
 
             ptrToOutputShape->addPoint(InchPoint(x, y));
           }
@@ -209,4 +210,17 @@ std::shared_ptr<libpagemaker::OutputShape> libpagemaker::newOutputShape(
     }
   }
 }
+
+void libpagemaker::OutputShape::addPoints(const std::vector<PMDShapePoint> &points, const InchPoint &translate)
+{
+  const std::size_t first = m_points.size();
+  m_points.resize(first + points.size(), InchPoint(0, 0));
+  InchPoint *const out = m_points.data() + first;
+  for (std::size_t i = 0; i != points.size(); ++i)
+  {
+    out[i].m_x = points[i].m_x.toInches() + translate.m_x;
+    out[i].m_y = points[i].m_y.toInches() + translate.m_y;
+  }
+}
+
 /* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -33,32 +33,30 @@ class OutputShape
   double m_bboxLeft, m_bboxTop, m_bboxRight, m_bboxBot;
   PMDFillProperties m_fillProps;
   PMDStrokeProperties m_strokeProps;
-  std::string m_text;
-  std::vector<PMDCharProperties> m_charProps;
-  std::vector<PMDParaProperties> m_paraProps;
-  librevenge::RVNGBinaryData m_bitmap;
+  std::shared_ptr<const PMDStory> m_story;
+  std::shared_ptr<const PMDBitmapSource> m_bitmap;
   double m_width,m_height;
 
 public:
   OutputShape(bool isClosed, int shape, double rotation, double skew, const PMDFillProperties &fillProps, const PMDStrokeProperties &strokeProps)
     : m_isClosed(isClosed), m_shapeType(shape), m_points(), m_rotation(rotation), m_skew(skew),
-      m_bboxLeft(), m_bboxTop(), m_bboxRight(), m_bboxBot(), m_fillProps(fillProps), m_strokeProps(strokeProps), m_text(), m_charProps(),  m_paraProps(), m_bitmap(), m_width(), m_height()
+      m_bboxLeft(), m_bboxTop(), m_bboxRight(), m_bboxBot(), m_fillProps(fillProps), m_strokeProps(strokeProps), m_story(), m_bitmap(), m_width(), m_height()
   { }
 
-  OutputShape(bool isClosed, int shape, double rotation, double skew, std::string text, std::vector<PMDCharProperties> charProps, std::vector<PMDParaProperties> paraProps)
+  OutputShape(bool isClosed, int shape, double rotation, double skew, const std::shared_ptr<const PMDStory> &story)
     : m_isClosed(isClosed), m_shapeType(shape), m_points(), m_rotation(rotation), m_skew(skew),
       m_bboxLeft(), m_bboxTop(), m_bboxRight(), m_bboxBot(),
       m_fillProps(),
       m_strokeProps(),
-      m_text(text), m_charProps(charProps), m_paraProps(paraProps), m_bitmap(), m_width(), m_height()
+      m_story(story), m_bitmap(), m_width(), m_height()
   { }
 
-  OutputShape(bool isClosed, int shape, double rotation, double skew, librevenge::RVNGBinaryData bitmap)
+  OutputShape(bool isClosed, int shape, double rotation, double skew, const std::shared_ptr<const PMDBitmapSource> &bitmap)
     : m_isClosed(isClosed), m_shapeType(shape), m_points(), m_rotation(rotation), m_skew(skew),
       m_bboxLeft(), m_bboxTop(), m_bboxRight(), m_bboxBot(),
       m_fillProps(),
       m_strokeProps(),
-      m_text(), m_charProps(), m_paraProps(), m_bitmap(bitmap), m_width(), m_height()
+      m_story(), m_bitmap(bitmap), m_width(), m_height()
   { }
 
   unsigned numPoints() const
@@ -101,29 +99,31 @@ public:
     return m_skew;
   }
 
-  std::string getText() const
+  // The text accessors must only be used for text boxes.
+  const std::string &getText() const
   {
-    return m_text;
+    return m_story->m_text;
   }
 
-  std::vector<PMDCharProperties> getCharProperties() const
+  const std::vector<PMDCharProperties> &getCharProperties() const
   {
-    return m_charProps;
+    return m_story->m_charProps;
   }
 
-  std::vector<PMDParaProperties> getParaProperties() const
+  const std::vector<PMDParaProperties> &getParaProperties() const
   {
-    return m_paraProps;
+    return m_story->m_paraProps;
   }
 
-  librevenge::RVNGBinaryData getBitmap() const
+  // Must only be used for bitmaps.
+  const std::shared_ptr<const PMDBitmapSource> &getBitmap() const
   {
     return m_bitmap;
   }
 
   std::pair<InchPoint, InchPoint> getBoundingBox() const
   {
-    if (m_points.empty() && m_bitmap.empty())
+    if (m_points.empty() && (!m_bitmap || m_bitmap->empty()))
     {
       throw EmptyLineSetException();
     }
@@ -143,6 +143,9 @@ public:
     m_points.push_back(InchPoint(point.m_x, point.m_y));
   }
 
+  /// Converts points to inches, moves them by translate and appends them.
+  void addPoints(const std::vector<PMDShapePoint> &points, const InchPoint &translate);
+
   void setDimensions(double width, double height)
   {
     m_width = width,
@@ -0,0 +1,45 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDALLOCATIONSCOPE_H__
+#define __PMDALLOCATIONSCOPE_H__
+
+#include <boost/cstdint.hpp>
+
+#include <libpagemaker/libpagemaker.h>
+
+namespace libpagemaker
+{
+
+/**
+ * Attributes the allocations of the current thread to a phase and a
+ * shape kind until the end of its scope.
+ */
+class PMDAllocationScope
+{
+  const unsigned char m_previousPhase;
+  const unsigned char m_previousShape;
+
+  /* Prevent copy and assignment */
+  PMDAllocationScope &operator=(const PMDAllocationScope &);
+  PMDAllocationScope(const PMDAllocationScope &);
+
+public:
+  PMDAllocationScope(PMDAllocationPhase phase, PMDAllocationShape shape);
+  ~PMDAllocationScope();
+};
+
+/// The allocation shape kind of a SHAPE_TYPE_* value.
+PMDAllocationShape getAllocationShape(uint8_t shapeType);
+
+}
+
+#endif /* __PMDALLOCATIONSCOPE_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
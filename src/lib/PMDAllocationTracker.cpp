@@ -0,0 +1,167 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <atomic>
+
+#include <libpagemaker/libpagemaker.h>
+
+#include "PMDAllocationScope.h"
+#include "constants.h"
+
+namespace libpagemaker
+{
+
+namespace
+{
+
+/*
+ * A tag holds the shape kind in bits 0-3, the phase in bits 4-7 and the
+ * tracking session in the remaining bits. Session 0 means "not tracked",
+ * so memory allocated before a start() is never subtracted afterwards.
+ */
+const unsigned TAG_PHASE_SHIFT = 4;
+const unsigned TAG_SESSION_SHIFT = 8;
+
+struct Counter
+{
+  std::atomic<unsigned long> m_allocations;
+  std::atomic<unsigned long> m_bytes;
+  std::atomic<unsigned long> m_liveBytes;
+  std::atomic<unsigned long> m_peakBytes;
+};
+
+// All of these are zero-initialized before any dynamic initialization,
+// so they can be used by allocations made during static initialization.
+std::atomic<unsigned> g_session;
+std::atomic<bool> g_tracking;
+Counter g_total;
+Counter g_phases[PMD_ALLOCATION_PHASE_COUNT];
+Counter g_shapes[PMD_ALLOCATION_SHAPE_COUNT];
+
+thread_local unsigned char t_phase = PMD_ALLOCATION_PHASE_OTHER;
+thread_local unsigned char t_shape = PMD_ALLOCATION_SHAPE_NONE;
+
+void reset(Counter &counter)
+{
+  counter.m_allocations = 0;
+  counter.m_bytes = 0;
+  counter.m_liveBytes = 0;
+  counter.m_peakBytes = 0;
+}
+
+void add(Counter &counter, const std::size_t size)
+{
+  ++counter.m_allocations;
+  counter.m_bytes += size;
+  const unsigned long live = counter.m_liveBytes += size;
+  unsigned long peak = counter.m_peakBytes;
+  while (live > peak && !counter.m_peakBytes.compare_exchange_weak(peak, live))
+    ;
+}
+
+void remove(Counter &counter, const std::size_t size)
+{
+  counter.m_liveBytes -= size;
+}
+
+void get(const Counter &counter, PMDAllocationCounts &counts)
+{
+  counts.m_allocations = counter.m_allocations;
+  counts.m_bytes = counter.m_bytes;
+  counts.m_peakBytes = counter.m_peakBytes;
+}
+
+}
+
+PMDAllocationScope::PMDAllocationScope(const PMDAllocationPhase phase, const PMDAllocationShape shape)
+  : m_previousPhase(t_phase), m_previousShape(t_shape)
+{
+  t_phase = static_cast<unsigned char>(phase);
+  t_shape = static_cast<unsigned char>(shape);
+}
+
+PMDAllocationScope::~PMDAllocationScope()
+{
+  t_phase = m_previousPhase;
+  t_shape = m_previousShape;
+}
+
+PMDAllocationShape getAllocationShape(const uint8_t shapeType)
+{
+  switch (shapeType)
+  {
+  case SHAPE_TYPE_LINE:
+    return PMD_ALLOCATION_SHAPE_LINE;
+  case SHAPE_TYPE_POLY:
+    return PMD_ALLOCATION_SHAPE_POLYGON;
+  case SHAPE_TYPE_RECT:
+    return PMD_ALLOCATION_SHAPE_RECTANGLE;
+  case SHAPE_TYPE_ELLIPSE:
+    return PMD_ALLOCATION_SHAPE_ELLIPSE;
+  case SHAPE_TYPE_TEXTBOX:
+    return PMD_ALLOCATION_SHAPE_TEXT;
+  case SHAPE_TYPE_BITMAP:
+    return PMD_ALLOCATION_SHAPE_BITMAP;
+  default:
+    return PMD_ALLOCATION_SHAPE_NONE;
+  }
+}
+
+void PMDAllocationTracker::start()
+{
+  g_tracking = false;
+  reset(g_total);
+  for (auto &counter : g_phases)
+    reset(counter);
+  for (auto &counter : g_shapes)
+    reset(counter);
+  ++g_session;
+  if ((g_session << TAG_SESSION_SHIFT) == 0)
+    g_session = 1;
+  g_tracking = true;
+}
+
+void PMDAllocationTracker::stop()
+{
+  g_tracking = false;
+}
+
+void PMDAllocationTracker::getStats(PMDAllocationStats &stats)
+{
+  get(g_total, stats.m_total);
+  for (unsigned i = 0; i != PMD_ALLOCATION_PHASE_COUNT; ++i)
+    get(g_phases[i], stats.m_phases[i]);
+  for (unsigned i = 0; i != PMD_ALLOCATION_SHAPE_COUNT; ++i)
+    get(g_shapes[i], stats.m_shapes[i]);
+}
+
+unsigned PMDAllocationTracker::allocated(const std::size_t size)
+{
+  if (!g_tracking)
+    return 0;
+
+  add(g_total, size);
+  add(g_phases[t_phase], size);
+  add(g_shapes[t_shape], size);
+  return (g_session << TAG_SESSION_SHIFT) | (unsigned(t_phase) << TAG_PHASE_SHIFT) | t_shape;
+}
+
+void PMDAllocationTracker::deallocated(const unsigned tag, const std::size_t size)
+{
+  if ((tag >> TAG_SESSION_SHIFT) != g_session || !g_tracking)
+    return;
+
+  remove(g_total, size);
+  remove(g_phases[(tag >> TAG_PHASE_SHIFT) & 0xf], size);
+  remove(g_shapes[tag & 0xf], size);
+}
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,235 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDBYTEREADER_H__
+#define __PMDBYTEREADER_H__
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+
+#include "libpagemaker_utils.h"
+
+namespace libpagemaker
+{
+
+/**
+ * Provider of the data of a PMDByteReader that does not hold all of it
+ * in memory.
+ */
+class PMDByteSource
+{
+public:
+  virtual ~PMDByteSource()
+  {
+  }
+
+  /**
+   * Makes the data from offset on available, at least numBytes of them
+   * unless the data end earlier. The returned block stays valid until
+   * the next call.
+   *
+   * \param length Receives the number of bytes available at the returned address
+   */
+  virtual const unsigned char *load(unsigned long offset, unsigned long numBytes, unsigned long &length) = 0;
+};
+
+/**
+ * Bounds-checked read cursor over a contiguous block of memory.
+ *
+ * It mirrors the stream-based helpers from libpagemaker_utils.h, but
+ * every read is a plain memory access instead of a virtual call into
+ * librevenge. Reading past the end throws EndOfStreamException,
+ * seeking past the end throws SeekFailedException.
+ *
+ * The reader does not own the data. Alternatively, it reads through a
+ * window that it moves over the data of a PMDByteSource, whenever a
+ * read or seek leaves the window. Blocks returned by readNBytes() then
+ * stay valid only until the window moves.
+ *
+ * The reader counts the bytes read and the seeks, for the parser's work
+ * accounting.
+ */
+class PMDByteReader
+{
+  const unsigned char *m_begin;
+  const unsigned char *m_end;
+  const unsigned char *m_pos;
+  // Offset of m_begin in the data.
+  unsigned long m_origin;
+  unsigned long m_length;
+  PMDByteSource *m_source;
+  unsigned long m_bytesRead;
+  unsigned long m_seeks;
+
+public:
+  PMDByteReader()
+    : m_begin(nullptr), m_end(nullptr), m_pos(nullptr), m_origin(0), m_length(0), m_source(nullptr), m_bytesRead(0), m_seeks(0)
+  { }
+
+  PMDByteReader(const unsigned char *const data, const std::size_t length)
+    : m_begin(data), m_end(data + length), m_pos(data), m_origin(0), m_length(length), m_source(nullptr), m_bytesRead(0), m_seeks(0)
+  { }
+
+  explicit PMDByteReader(const std::vector<unsigned char> &data)
+    : m_begin(data.empty() ? nullptr : &data[0]), m_end(m_begin + data.size()), m_pos(m_begin), m_origin(0), m_length(data.size()),
+      m_source(nullptr), m_bytesRead(0), m_seeks(0)
+  { }
+
+  /// Reads length bytes from source, which is not owned.
+  PMDByteReader(PMDByteSource &source, const unsigned long length)
+    : m_begin(nullptr), m_end(nullptr), m_pos(nullptr), m_origin(0), m_length(length), m_source(&source), m_bytesRead(0), m_seeks(0)
+  { }
+
+  uint8_t readU8()
+  {
+    return *require(1);
+  }
+
+  uint16_t readU16(const bool bigEndian)
+  {
+    const unsigned char *const p = require(2);
+    if (bigEndian)
+      return static_cast<uint16_t>((uint16_t)p[1]|((uint16_t)p[0]<<8));
+    return static_cast<uint16_t>((uint16_t)p[0]|((uint16_t)p[1]<<8));
+  }
+
+  uint32_t readU32(const bool bigEndian)
+  {
+    const unsigned char *const p = require(4);
+    if (bigEndian)
+      return (uint32_t)p[3]|((uint32_t)p[2]<<8)|((uint32_t)p[1]<<16)|((uint32_t)p[0]<<24);
+    return (uint32_t)p[0]|((uint32_t)p[1]<<8)|((uint32_t)p[2]<<16)|((uint32_t)p[3]<<24);
+  }
+
+  const unsigned char *readNBytes(const unsigned long numBytes)
+  {
+    return require(numBytes);
+  }
+
+  void skip(const unsigned long numBytes)
+  {
+    require(numBytes);
+  }
+
+  void seek(const unsigned long pos)
+  {
+    if (pos > length())
+      throw SeekFailedException();
+    if (pos >= m_origin && pos - m_origin <= static_cast<unsigned long>(m_end - m_begin))
+      m_pos = m_begin + (pos - m_origin);
+    else
+      moveWindow(pos, 0);
+    ++m_seeks;
+  }
+
+  unsigned long tell() const
+  {
+    return m_origin + static_cast<unsigned long>(m_pos - m_begin);
+  }
+
+  unsigned long length() const
+  {
+    return m_length;
+  }
+
+  bool isEnd() const
+  {
+    return tell() == m_length;
+  }
+
+  /// Returns the bytes read and the seeks since the previous call.
+  void takeCounts(unsigned long &bytesRead, unsigned long &seeks)
+  {
+    bytesRead = m_bytesRead;
+    seeks = m_seeks;
+    m_bytesRead = 0;
+    m_seeks = 0;
+  }
+
+private:
+  void moveWindow(const unsigned long pos, const unsigned long numBytes)
+  {
+    if (!m_source)
+      throw EndOfStreamException();
+    unsigned long available = 0;
+    m_begin = m_source->load(pos, numBytes, available);
+    m_end = m_begin + available;
+    m_pos = m_begin;
+    m_origin = pos;
+  }
+
+  const unsigned char *require(const unsigned long numBytes)
+  {
+    if (numBytes > static_cast<unsigned long>(m_end - m_pos))
+    {
+      if (!m_source || numBytes > m_length - tell())
+        throw EndOfStreamException();
+      moveWindow(tell(), numBytes);
+      if (numBytes > static_cast<unsigned long>(m_end - m_pos))
+        throw EndOfStreamException();
+    }
+    const unsigned char *const p = m_pos;
+    m_pos += numBytes;
+    m_bytesRead += numBytes;
+    return p;
+  }
+};
+
+inline uint8_t readU8(PMDByteReader &input, bool = false)
+{
+  return input.readU8();
+}
+
+inline int8_t readS8(PMDByteReader &input, bool = false)
+{
+  return static_cast<int8_t>(input.readU8());
+}
+
+inline uint16_t readU16(PMDByteReader &input, const bool bigEndian = false)
+{
+  return input.readU16(bigEndian);
+}
+
+inline int16_t readS16(PMDByteReader &input, const bool bigEndian = false)
+{
+  return static_cast<int16_t>(input.readU16(bigEndian));
+}
+
+inline uint32_t readU32(PMDByteReader &input, const bool bigEndian = false)
+{
+  return input.readU32(bigEndian);
+}
+
+inline int32_t readS32(PMDByteReader &input, const bool bigEndian = false)
+{
+  return static_cast<int32_t>(input.readU32(bigEndian));
+}
+
+inline const unsigned char *readNBytes(PMDByteReader &input, const unsigned long numBytes)
+{
+  return input.readNBytes(numBytes);
+}
+
+inline void skip(PMDByteReader &input, const unsigned long numBytes)
+{
+  input.skip(numBytes);
+}
+
+inline void seek(PMDByteReader &input, const unsigned long pos)
+{
+  input.seek(pos);
+}
+
+}
+
+#endif /* __PMDBYTEREADER_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
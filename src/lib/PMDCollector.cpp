@@ -9,12 +9,14 @@
 
 #include "PMDCollector.h"
 
+#include <algorithm>
 #include <iostream>
 #include <math.h>
 #include <string>
 #include <utility>
 
 #include "OutputShape.h"
+#include "PMDAllocationScope.h"
 #include "constants.h"
 #include "libpagemaker_utils.h"
 
@@ -132,11 +134,33 @@ void writeBorder(librevenge::RVNGPropertyList &props, const char *const name, co
   props.insert(name, border);
 }
 
+#ifdef PMD_ENABLE_STATS
+PMDStatsPhase getPaintPhase(const uint8_t shapeType)
+{
+  switch (shapeType)
+  {
+  case SHAPE_TYPE_LINE:
+    return PMD_PHASE_PAINT_LINE;
+  case SHAPE_TYPE_POLY:
+    return PMD_PHASE_PAINT_POLYGON;
+  case SHAPE_TYPE_RECT:
+    return PMD_PHASE_PAINT_RECTANGLE;
+  case SHAPE_TYPE_TEXTBOX:
+    return PMD_PHASE_PAINT_TEXT;
+  case SHAPE_TYPE_BITMAP:
+    return PMD_PHASE_PAINT_BITMAP;
+  default:
+    return PMD_PHASE_PAINT_ELLIPSE;
+  }
+}
+#endif
+
 }
 
 PMDCollector::PMDCollector() :
   m_pageWidth(), m_pageHeight(), m_pages(), m_color(),m_font(),
-  m_doubleSided(false)
+  m_doubleSided(false), m_firstPage(0), m_lastPage(static_cast<unsigned>(-1)), m_imageSink(nullptr), m_storedImages(), m_stats(), m_progress(),
+  m_painter(nullptr), m_pendingShapes()
 { }
 
 void PMDCollector::setDoubleSided(bool doubleSided)
@@ -144,6 +168,17 @@ void PMDCollector::setDoubleSided(bool doubleSided)
   m_doubleSided = doubleSided;
 }
 
+void PMDCollector::setPageRange(const unsigned firstPage, const unsigned lastPage)
+{
+  m_firstPage = firstPage;
+  m_lastPage = lastPage;
+}
+
+void PMDCollector::setImageSink(PMDImageSink *const imageSink)
+{
+  m_imageSink = imageSink;
+}
+
 /* State-mutating functions */
 void PMDCollector::setPageWidth(PMDShapeUnit pageWidth)
 {
@@ -155,12 +190,54 @@ void PMDCollector::setPageHeight(PMDShapeUnit pageHeight)
   m_pageHeight = pageHeight;
 }
 
+void PMDCollector::enableStats()
+{
+  m_stats.reset(new PMDStats());
+}
+
+PMDStats *PMDCollector::getStats() const
+{
+  return m_stats.get();
+}
+
+void PMDCollector::enableProgress(PMDProgress *const progress)
+{
+  m_progress.reset(new PMDProgressReporter(progress));
+}
+
+PMDProgressReporter *PMDCollector::getProgress() const
+{
+  return m_progress.get();
+}
+
 unsigned PMDCollector::addPage()
 {
   m_pages.push_back((PMDPage()));
   return m_pages.size() - 1;
 }
 
+bool PMDCollector::isPageUsed(const unsigned pageID) const
+{
+  if (pageID < m_firstPage)
+    return false;
+  if (pageID <= m_lastPage)
+    return true;
+  // In a double-sided document, the left side of output page n comes from page n + 1.
+  return m_doubleSided && pageID - 1 <= m_lastPage;
+}
+
+unsigned PMDCollector::countOutputPages() const
+{
+  if (m_firstPage >= m_pages.size())
+    return 0;
+  return (std::min)(static_cast<size_t>(m_lastPage), m_pages.size() - 1) - m_firstPage + 1;
+}
+
+const PMDPage &PMDCollector::getPage(const unsigned pageID) const
+{
+  return m_pages.at(pageID);
+}
+
 void PMDCollector::addColor(const PMDColor &color)
 {
   m_color.push_back(color);
@@ -179,6 +256,8 @@ void PMDCollector::addShapeToPage(unsigned pageID, const std::shared_ptr<PMDLine
 void PMDCollector::paintShape(const OutputShape &shape,
                               librevenge::RVNGDrawingInterface *painter) const
 {
+  PMD_TIME_PHASE(getStats(), getPaintPhase(shape.shapeType()));
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PAINT, getAllocationShape(shape.shapeType()));
   if (shape.shapeType() == SHAPE_TYPE_LINE || shape.shapeType() == SHAPE_TYPE_POLY || shape.shapeType() == SHAPE_TYPE_RECT)
   {
     librevenge::RVNGPropertyListVector vertices;
@@ -285,9 +364,11 @@ void PMDCollector::paintShape(const OutputShape &shape,
     uint16_t paraEnd = 0;
     uint16_t paraLength = 0;
 
-    std::vector<PMDParaProperties> paraProperties = shape.getParaProperties();
+    const std::vector<PMDParaProperties> &paraProperties = shape.getParaProperties();
+    const std::vector<PMDCharProperties> &charProperties = shape.getCharProperties();
+    const std::string &text = shape.getText();
 
-    for (auto &paraProperty : paraProperties)
+    for (const auto &paraProperty : paraProperties)
     {
 
       paraLength = paraProperty.m_length;
@@ -364,14 +445,11 @@ void PMDCollector::paintShape(const OutputShape &shape,
 
       //charProps.insert("style:font-name", "Ubuntu");
 
-      std::string tempText = shape.getText();
-      std::vector<PMDCharProperties> charProperties = shape.getCharProperties();
-
       uint16_t charStart = 0;
       uint16_t charEnd = 0;
       uint16_t charLength = 0;
 
-      for (auto &charProperty : charProperties)
+      for (const auto &charProperty : charProperties)
       {
         charLength = charProperty.m_length;
         uint16_t charEndTemp = charStart + charLength -1;
@@ -451,7 +529,7 @@ void PMDCollector::paintShape(const OutputShape &shape,
 
 
           painter->openSpan(charProps);
-          writeTextSpan(tempText, charStart, charEnd, painter);
+          writeTextSpan(text, charStart, charEnd, painter);
           painter->closeSpan();
         }
 
@@ -476,8 +554,24 @@ void PMDCollector::paintShape(const OutputShape &shape,
     if (shape.getRotation() != 0.0)
       props.insert("librevenge:rotate", shape.getRotation() * 180 / M_PI, librevenge::RVNG_GENERIC);
 
-    props.insert("librevenge:mime-type", "image/tiff");
-    props.insert("office:binary-data", shape.getBitmap());
+    const librevenge::RVNGString mimeType("image/tiff");
+    props.insert("librevenge:mime-type", mimeType);
+    // The bitmap only exists in memory while it is being painted.
+    if (m_imageSink)
+    {
+      // Identical images share one PMDBitmapSource, so each is stored only once.
+      auto it = m_storedImages.find(shape.getBitmap());
+      if (it == m_storedImages.end())
+      {
+        const librevenge::RVNGString ref = m_imageSink->storeImage(shape.getBitmap()->read(), mimeType);
+        it = m_storedImages.insert(std::make_pair(shape.getBitmap(), ref)).first;
+      }
+      props.insert("xlink:href", it->second);
+    }
+    else
+    {
+      props.insert("office:binary-data", shape.getBitmap()->read());
+    }
     painter->drawGraphicObject(props);
   }
   else
@@ -624,6 +718,7 @@ void PMDCollector::writePage(const PMDPage & /*page*/,
                              librevenge::RVNGDrawingInterface *painter,
                              const std::vector<std::shared_ptr<const OutputShape> > &outputShapes) const
 {
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PAINT, PMD_ALLOCATION_SHAPE_NONE);
   librevenge::RVNGPropertyList pageProps;
   if (m_pageWidth.is_initialized())
   {
@@ -641,86 +736,154 @@ void PMDCollector::writePage(const PMDPage & /*page*/,
     paintShape(*outputShape, painter);
   }
   painter->endPage();
+  if (m_progress)
+    m_progress->pagePainted();
 }
 
-void PMDCollector::fillOutputShapesByPage_TwoSided(PageShapesList_t &pageShapes) const
+void PMDCollector::splitSpreadShapes(const PMDPage &page, const bool leftPageExists,
+                                     PageShapes_t &rightShapes, PageShapes_t &leftShapes) const
 {
-  pageShapes.assign(m_pages.size() * 2 - 1, PageShapes_t()); // the first "page" only has right side
-
+  PMD_TIME_PHASE(getStats(), PMD_PHASE_OUTPUT_SHAPES);
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_LAYOUT, PMD_ALLOCATION_SHAPE_NONE);
   double centerToEdge_x = m_pageWidth.get_value_or(0).toInches() / 2;
   double centerToEdge_y = m_pageHeight.get_value_or(0).toInches() / 2;
   InchPoint translateForLeftPage(centerToEdge_x * 2, centerToEdge_y);
   InchPoint translateForRightPage(0, centerToEdge_y);
 
-  for (size_t i = 0; i < m_pages.size(); ++i)
+  for (unsigned j = 0; j < page.numShapes(); ++j)
   {
-    const bool leftPageExists = (i > 0);
-
-    const PMDPage &page = m_pages[i];
-    for (unsigned j = 0; j < page.numShapes(); ++j)
+    std::shared_ptr<const OutputShape> right = newOutputShape(page.getShape(j), translateForRightPage);
+    if (right->getBoundingBox().second.m_x >= 0)
+    {
+      rightShapes.push_back(right);
+      continue;
+    }
+    if (leftPageExists)
     {
-      std::shared_ptr<const OutputShape> right = newOutputShape(page.getShape(j), translateForRightPage);
-      if (right->getBoundingBox().second.m_x >= 0)
+      std::shared_ptr<const OutputShape> left = newOutputShape(page.getShape(j), translateForLeftPage);
+      if (left->getBoundingBox().first.m_x <= centerToEdge_x * 2)
       {
-        pageShapes[i].push_back(right);
-        continue;
-      }
-      if (leftPageExists)
-      {
-        std::shared_ptr<const OutputShape> left = newOutputShape(page.getShape(j), translateForLeftPage);
-        if (left->getBoundingBox().first.m_x <= centerToEdge_x * 2)
-        {
-          pageShapes[i - 1].push_back(left);
-        }
+        leftShapes.push_back(left);
       }
     }
   }
-
-  if ((pageShapes.size() > 1) && pageShapes.back().empty()) // the last "page" only has left side
-    pageShapes.pop_back();
 }
 
-void PMDCollector::fillOutputShapesByPage_OneSided(PageShapesList_t &pageShapes) const
+void PMDCollector::fillOutputShapes_OneSided(const PMDPage &page, PageShapes_t &shapes) const
 {
-  pageShapes.reserve(m_pages.size());
-  pageShapes.assign(m_pages.size(), PageShapes_t());
-
+  PMD_TIME_PHASE(getStats(), PMD_PHASE_OUTPUT_SHAPES);
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_LAYOUT, PMD_ALLOCATION_SHAPE_NONE);
   double centerToEdge_x = m_pageWidth.get().toInches() / 2;
   double centerToEdge_y = m_pageHeight.get().toInches() / 2;
   InchPoint translateShapes(centerToEdge_x, centerToEdge_y);
 
-  for (size_t i = 0; i < m_pages.size(); ++i)
+  shapes.reserve(page.numShapes());
+  for (unsigned j = 0; j < page.numShapes(); ++j)
+  {
+    shapes.push_back(newOutputShape(page.getShape(j), translateShapes));
+  }
+}
+
+bool PMDCollector::isOutputPage(const size_t pageID) const
+{
+  return pageID >= m_firstPage && pageID <= m_lastPage;
+}
+
+/*
+ * Writes the output pages that are complete once page pageID has been
+ * collected. In a double-sided document, output page n consists of the
+ * right side of page n and the left side of page n + 1, so the right side
+ * of the last page is kept in pendingShapes until the next page arrives.
+ */
+void PMDCollector::writeCompletedPages(const size_t pageID, PageShapes_t &pendingShapes,
+                                       librevenge::RVNGDrawingInterface *painter) const
+{
+  const PMDPage &page = m_pages[pageID];
+
+  if (!m_doubleSided)
   {
-    const PMDPage &page = m_pages[i];
-    for (unsigned j = 0; j < page.numShapes(); ++j)
+    if (isOutputPage(pageID))
     {
-      pageShapes[i].push_back(newOutputShape(page.getShape(j), translateShapes));
+      PageShapes_t shapes;
+      fillOutputShapes_OneSided(page, shapes);
+      writePage(page, painter, shapes);
     }
+    return;
+  }
+
+  PageShapes_t rightShapes;
+  PageShapes_t leftShapes;
+  const bool leftPageExists = pageID > 0;
+  if (isOutputPage(pageID) || (leftPageExists && isOutputPage(pageID - 1)))
+    splitSpreadShapes(page, leftPageExists, rightShapes, leftShapes);
+
+  if (leftPageExists && isOutputPage(pageID - 1))
+  {
+    pendingShapes.insert(pendingShapes.end(), leftShapes.begin(), leftShapes.end());
+    writePage(m_pages[pageID - 1], painter, pendingShapes);
   }
+  pendingShapes.swap(rightShapes);
 }
 
-void PMDCollector::fillOutputShapesByPage(PageShapesList_t &pageShapes) const
+void PMDCollector::writeLastPage(PageShapes_t &pendingShapes, librevenge::RVNGDrawingInterface *painter) const
 {
-  if (m_doubleSided)
-    fillOutputShapesByPage_TwoSided(pageShapes);
-  else
-    fillOutputShapesByPage_OneSided(pageShapes);
+  if (m_doubleSided && !m_pages.empty() && isOutputPage(m_pages.size() - 1))
+    writePage(m_pages.back(), painter, pendingShapes);
+  pendingShapes.clear();
+}
+
+void PMDCollector::fillInfo(PMDDocumentInfo &info) const
+{
+  info.m_pageWidth = m_pageWidth.get_value_or(0).toInches();
+  info.m_pageHeight = m_pageHeight.get_value_or(0).toInches();
+  info.m_doubleSided = m_doubleSided;
+  for (const auto &font : m_font)
+    info.m_fonts.append(font.m_fontName.c_str());
+  for (const auto &color : m_color)
+  {
+    librevenge::RVNGString colorString;
+    colorString.sprintf("#%.2x%.2x%.2x", color.m_red, color.m_green, color.m_blue);
+    info.m_colors.append(colorString);
+  }
 }
 
 /* Output functions */
 void PMDCollector::draw(librevenge::RVNGDrawingInterface *painter) const
 {
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PAINT, PMD_ALLOCATION_SHAPE_NONE);
   painter->startDocument(librevenge::RVNGPropertyList());
 
-  PageShapesList_t shapesByPage;
-  fillOutputShapesByPage(shapesByPage);
+  PageShapes_t pendingShapes;
   for (size_t i = 0; i < m_pages.size(); ++i)
-  {
-    PageShapes_t shapes = shapesByPage[i];
-    writePage(m_pages[i], painter, shapes);
-  }
+    writeCompletedPages(i, pendingShapes, painter);
+  writeLastPage(pendingShapes, painter);
+
   painter->endDocument();
 }
 
+void PMDCollector::startStreaming(librevenge::RVNGDrawingInterface *painter)
+{
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PAINT, PMD_ALLOCATION_SHAPE_NONE);
+  m_painter = painter;
+  m_painter->startDocument(librevenge::RVNGPropertyList());
+}
+
+void PMDCollector::pageComplete(const unsigned pageID)
+{
+  if (!m_painter)
+    return;
+
+  writeCompletedPages(pageID, m_pendingShapes, m_painter);
+  m_pages[pageID] = PMDPage();
+}
+
+void PMDCollector::endStreaming()
+{
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PAINT, PMD_ALLOCATION_SHAPE_NONE);
+  writeLastPage(m_pendingShapes, m_painter);
+  m_painter->endDocument();
+  m_painter = nullptr;
+}
+
 }
 /* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -10,12 +10,17 @@
 #ifndef __PMDCOLLECTOR_H__
 #define __PMDCOLLECTOR_H__
 
+#include <map>
 #include <memory>
 #include <vector>
 
 #include <boost/optional.hpp>
 
+#include <libpagemaker/libpagemaker.h>
+
 #include "PMDPage.h"
+#include "PMDProgressReporter.h"
+#include "PMDStats.h"
 #include "PMDTypes.h"
 #include "Units.h"
 #include "geometry.h"
@@ -36,7 +41,6 @@ class PMDLineSet;
 class PMDCollector
 {
   typedef std::vector<std::shared_ptr<const OutputShape> > PageShapes_t;
-  typedef std::vector<PageShapes_t> PageShapesList_t;
 
   /*
    * Height and width in PMD page units.
@@ -49,6 +53,17 @@ class PMDCollector
   std::vector<PMDColor> m_color;
   std::vector<PMDFont> m_font;
   bool m_doubleSided;
+  unsigned m_firstPage;
+  unsigned m_lastPage;
+  PMDImageSink *m_imageSink;
+  // References to the images already passed to the image sink. Filled during output.
+  mutable std::map<std::shared_ptr<const PMDBitmapSource>, librevenge::RVNGString> m_storedImages;
+  std::unique_ptr<PMDStats> m_stats;
+  std::unique_ptr<PMDProgressReporter> m_progress;
+
+  /* Streaming state */
+  librevenge::RVNGDrawingInterface *m_painter;
+  PageShapes_t m_pendingShapes;
 
   void writePage(const PMDPage &,
                  librevenge::RVNGDrawingInterface *,
@@ -57,9 +72,17 @@ class PMDCollector
   void paintShape(const OutputShape &shape,
                   librevenge::RVNGDrawingInterface *) const;
 
-  void fillOutputShapesByPage_OneSided(PageShapesList_t &pageShapes) const;
-  void fillOutputShapesByPage_TwoSided(PageShapesList_t &pageShapes) const;
-  void fillOutputShapesByPage(PageShapesList_t &pageShapes) const;
+  void splitSpreadShapes(const PMDPage &page, bool leftPageExists,
+                         PageShapes_t &rightShapes, PageShapes_t &leftShapes) const;
+  void fillOutputShapes_OneSided(const PMDPage &page, PageShapes_t &shapes) const;
+  bool isOutputPage(size_t pageID) const;
+  void writeCompletedPages(size_t pageID, PageShapes_t &pendingShapes,
+                           librevenge::RVNGDrawingInterface *) const;
+  void writeLastPage(PageShapes_t &pendingShapes, librevenge::RVNGDrawingInterface *) const;
+
+  /* Prevent copy and assignment */
+  PMDCollector &operator=(const PMDCollector &);
+  PMDCollector(const PMDCollector &);
 public:
   PMDCollector();
 
@@ -67,14 +90,45 @@ public:
   void setPageWidth(PMDShapeUnit);
   void setPageHeight(PMDShapeUnit);
   void setDoubleSided(bool);
+  void setPageRange(unsigned firstPage, unsigned lastPage);
+  void setImageSink(PMDImageSink *imageSink);
   void addShapeToPage(unsigned pageID, const std::shared_ptr<PMDLineSet> &shape);
   void addColor(const PMDColor &color);
   void addFont(const PMDFont &font);
 
   unsigned addPage();
 
+  /* Phase timings; null unless enabled */
+  void enableStats();
+  PMDStats *getStats() const;
+
+  /* Progress reports; null unless enabled */
+  void enableProgress(PMDProgress *progress);
+  PMDProgressReporter *getProgress() const;
+
+  /* Whether the shapes of a page appear on any output page */
+  bool isPageUsed(unsigned pageID) const;
+
+  /* Number of pages that draw() outputs */
+  unsigned countOutputPages() const;
+
+  /* Copies the document-level data into info; the page count is left alone */
+  void fillInfo(PMDDocumentInfo &info) const;
+
+  /* The collected shapes of a page, for the micro-benchmarks */
+  const PMDPage &getPage(unsigned pageID) const;
+
   /* Output functions */
   void draw(librevenge::RVNGDrawingInterface *) const;
+
+  /*
+   * Streaming output: after startStreaming(), every page is painted and
+   * its shapes released as soon as the parser reports it complete.
+   * Pages must be completed in order.
+   */
+  void startStreaming(librevenge::RVNGDrawingInterface *);
+  void pageComplete(unsigned pageID);
+  void endStreaming();
 };
 
 }
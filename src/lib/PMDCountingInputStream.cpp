@@ -0,0 +1,112 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "PMDCountingInputStream.h"
+
+namespace libpagemaker
+{
+
+PMDCountingInputStream::PMDCountingInputStream(librevenge::RVNGInputStream *const stream, PMDStreamStats &stats)
+  : librevenge::RVNGInputStream(), m_stream(stream), m_ownedStream(), m_state(std::make_shared<State>(stats))
+{
+}
+
+PMDCountingInputStream::PMDCountingInputStream(librevenge::RVNGInputStream *const stream, const std::shared_ptr<State> &state)
+  : librevenge::RVNGInputStream(), m_stream(stream), m_ownedStream(stream), m_state(state)
+{
+}
+
+void PMDCountingInputStream::setPhase(const PMDStreamPhase phase)
+{
+  m_state->m_phase = phase;
+}
+
+librevenge::RVNGInputStream *PMDCountingInputStream::wrap(librevenge::RVNGInputStream *const stream) const
+{
+  if (!stream)
+    return nullptr;
+  return new PMDCountingInputStream(stream, m_state);
+}
+
+PMDStreamPhaseStats &PMDCountingInputStream::getPhaseStats() const
+{
+  return m_state->m_stats.m_phases[m_state->m_phase];
+}
+
+bool PMDCountingInputStream::isStructured()
+{
+  return m_stream->isStructured();
+}
+
+unsigned PMDCountingInputStream::subStreamCount()
+{
+  return m_stream->subStreamCount();
+}
+
+const char *PMDCountingInputStream::subStreamName(const unsigned id)
+{
+  return m_stream->subStreamName(id);
+}
+
+bool PMDCountingInputStream::existsSubStream(const char *const name)
+{
+  return m_stream->existsSubStream(name);
+}
+
+librevenge::RVNGInputStream *PMDCountingInputStream::getSubStreamByName(const char *const name)
+{
+  return wrap(m_stream->getSubStreamByName(name));
+}
+
+librevenge::RVNGInputStream *PMDCountingInputStream::getSubStreamById(const unsigned id)
+{
+  return wrap(m_stream->getSubStreamById(id));
+}
+
+const unsigned char *PMDCountingInputStream::read(const unsigned long numBytes, unsigned long &numBytesRead)
+{
+  const unsigned char *const data = m_stream->read(numBytes, numBytesRead);
+  PMDStreamPhaseStats &stats = getPhaseStats();
+  ++stats.m_reads;
+  stats.m_bytesRead += numBytesRead;
+  return data;
+}
+
+int PMDCountingInputStream::seek(const long offset, const librevenge::RVNG_SEEK_TYPE seekType)
+{
+  const long before = m_stream->tell();
+  const int result = m_stream->seek(offset, seekType);
+  const long after = m_stream->tell();
+  PMDStreamPhaseStats &stats = getPhaseStats();
+  ++stats.m_seeks;
+  if (after < before)
+  {
+    ++stats.m_backwardSeeks;
+    stats.m_seekDistance += static_cast<unsigned long>(before - after);
+  }
+  else
+  {
+    stats.m_seekDistance += static_cast<unsigned long>(after - before);
+  }
+  return result;
+}
+
+long PMDCountingInputStream::tell()
+{
+  return m_stream->tell();
+}
+
+bool PMDCountingInputStream::isEnd()
+{
+  return m_stream->isEnd();
+}
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,77 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDCOUNTINGINPUTSTREAM_H__
+#define __PMDCOUNTINGINPUTSTREAM_H__
+
+#include <memory>
+
+#include <librevenge-stream/librevenge-stream.h>
+
+#include <libpagemaker/libpagemaker.h>
+
+namespace libpagemaker
+{
+
+/**
+ * Input stream that forwards to another stream and counts the
+ * accesses to it in a PMDStreamStats.
+ *
+ * Substreams opened through it are counted into the same stats. All
+ * of them share the current phase, which is set through setPhase().
+ */
+class PMDCountingInputStream : public librevenge::RVNGInputStream
+{
+  struct State
+  {
+    PMDStreamStats &m_stats;
+    PMDStreamPhase m_phase;
+
+    explicit State(PMDStreamStats &stats)
+      : m_stats(stats), m_phase(PMD_STREAM_PHASE_PROBE)
+    { }
+  };
+
+  librevenge::RVNGInputStream *m_stream;
+  // Owned if this is a substream.
+  std::unique_ptr<librevenge::RVNGInputStream> m_ownedStream;
+  std::shared_ptr<State> m_state;
+
+  PMDCountingInputStream(librevenge::RVNGInputStream *stream, const std::shared_ptr<State> &state);
+  librevenge::RVNGInputStream *wrap(librevenge::RVNGInputStream *stream) const;
+  PMDStreamPhaseStats &getPhaseStats() const;
+
+  /* Prevent copy and assignment */
+  PMDCountingInputStream &operator=(const PMDCountingInputStream &);
+  PMDCountingInputStream(const PMDCountingInputStream &);
+
+public:
+  /// Wraps stream, which is not owned.
+  PMDCountingInputStream(librevenge::RVNGInputStream *stream, PMDStreamStats &stats);
+
+  void setPhase(PMDStreamPhase phase);
+
+  bool isStructured() override;
+  unsigned subStreamCount() override;
+  const char *subStreamName(unsigned id) override;
+  bool existsSubStream(const char *name) override;
+  librevenge::RVNGInputStream *getSubStreamByName(const char *name) override;
+  librevenge::RVNGInputStream *getSubStreamById(unsigned id) override;
+
+  const unsigned char *read(unsigned long numBytes, unsigned long &numBytesRead) override;
+  int seek(long offset, librevenge::RVNG_SEEK_TYPE seekType) override;
+  long tell() override;
+  bool isEnd() override;
+};
+
+}
+
+#endif /* __PMDCOUNTINGINPUTSTREAM_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -16,6 +16,8 @@
 
 #include <librevenge/librevenge.h>
 
+#include <libpagemaker/libpagemaker.h>
+
 namespace libpagemaker
 {
 
@@ -67,6 +69,58 @@ struct UnknownRecordSizeException : public PMDParseException
   { }
 };
 
+struct CancelledException : public PMDParseException
+{
+  CancelledException()
+    : PMDParseException("Parsing has been cancelled.")
+  { }
+};
+
+struct LimitExceededException : public PMDParseException
+{
+  PMDParseError m_error;
+
+  LimitExceededException(PMDParseError error, const std::string &message)
+    : PMDParseException(message),
+      m_error(error)
+  { }
+};
+
+struct WorkBudgetExceededException : public LimitExceededException
+{
+  WorkBudgetExceededException()
+    : LimitExceededException(PMD_ERROR_WORK_BUDGET, "The work budget has been exceeded.")
+  { }
+};
+
+struct TimeLimitExceededException : public LimitExceededException
+{
+  TimeLimitExceededException()
+    : LimitExceededException(PMD_ERROR_TIME_LIMIT, "The time limit has been exceeded.")
+  { }
+};
+
+struct RecordLimitExceededException : public LimitExceededException
+{
+  RecordLimitExceededException()
+    : LimitExceededException(PMD_ERROR_RECORD_LIMIT, "The record limit has been exceeded.")
+  { }
+};
+
+struct BitmapLimitExceededException : public LimitExceededException
+{
+  BitmapLimitExceededException()
+    : LimitExceededException(PMD_ERROR_BITMAP_LIMIT, "The bitmap size limit has been exceeded.")
+  { }
+};
+
+struct PainterLimitExceededException : public LimitExceededException
+{
+  PainterLimitExceededException()
+    : LimitExceededException(PMD_ERROR_PAINTER_LIMIT, "The painter call limit has been exceeded.")
+  { }
+};
+
 }
 
 #endif /* __PMDEXCEPTIONS_H__ */
@@ -0,0 +1,324 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "PMDLimitedPainter.h"
+
+#include "PMDLimits.h"
+
+namespace libpagemaker
+{
+
+PMDLimitedPainter::PMDLimitedPainter(librevenge::RVNGDrawingInterface *const painter, PMDLimits &limits)
+  : librevenge::RVNGDrawingInterface(), m_painter(painter), m_limits(limits)
+{
+}
+
+void PMDLimitedPainter::startDocument(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->startDocument(propList);
+}
+
+void PMDLimitedPainter::endDocument()
+{
+  m_limits.countPainterCall();
+  m_painter->endDocument();
+}
+
+void PMDLimitedPainter::setDocumentMetaData(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->setDocumentMetaData(propList);
+}
+
+void PMDLimitedPainter::defineEmbeddedFont(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->defineEmbeddedFont(propList);
+}
+
+void PMDLimitedPainter::startPage(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->startPage(propList);
+}
+
+void PMDLimitedPainter::endPage()
+{
+  m_limits.countPainterCall();
+  m_painter->endPage();
+}
+
+void PMDLimitedPainter::startMasterPage(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->startMasterPage(propList);
+}
+
+void PMDLimitedPainter::endMasterPage()
+{
+  m_limits.countPainterCall();
+  m_painter->endMasterPage();
+}
+
+void PMDLimitedPainter::startLayer(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->startLayer(propList);
+}
+
+void PMDLimitedPainter::endLayer()
+{
+  m_limits.countPainterCall();
+  m_painter->endLayer();
+}
+
+void PMDLimitedPainter::startEmbeddedGraphics(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->startEmbeddedGraphics(propList);
+}
+
+void PMDLimitedPainter::endEmbeddedGraphics()
+{
+  m_limits.countPainterCall();
+  m_painter->endEmbeddedGraphics();
+}
+
+void PMDLimitedPainter::openGroup(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->openGroup(propList);
+}
+
+void PMDLimitedPainter::closeGroup()
+{
+  m_limits.countPainterCall();
+  m_painter->closeGroup();
+}
+
+void PMDLimitedPainter::setStyle(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->setStyle(propList);
+}
+
+void PMDLimitedPainter::drawRectangle(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->drawRectangle(propList);
+}
+
+void PMDLimitedPainter::drawEllipse(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->drawEllipse(propList);
+}
+
+void PMDLimitedPainter::drawPolyline(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->drawPolyline(propList);
+}
+
+void PMDLimitedPainter::drawPolygon(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->drawPolygon(propList);
+}
+
+void PMDLimitedPainter::drawPath(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->drawPath(propList);
+}
+
+void PMDLimitedPainter::drawGraphicObject(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->drawGraphicObject(propList);
+}
+
+void PMDLimitedPainter::drawConnector(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->drawConnector(propList);
+}
+
+void PMDLimitedPainter::startTextObject(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->startTextObject(propList);
+}
+
+void PMDLimitedPainter::endTextObject()
+{
+  m_limits.countPainterCall();
+  m_painter->endTextObject();
+}
+
+void PMDLimitedPainter::startTableObject(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->startTableObject(propList);
+}
+
+void PMDLimitedPainter::openTableRow(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->openTableRow(propList);
+}
+
+void PMDLimitedPainter::closeTableRow()
+{
+  m_limits.countPainterCall();
+  m_painter->closeTableRow();
+}
+
+void PMDLimitedPainter::openTableCell(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->openTableCell(propList);
+}
+
+void PMDLimitedPainter::closeTableCell()
+{
+  m_limits.countPainterCall();
+  m_painter->closeTableCell();
+}
+
+void PMDLimitedPainter::insertCoveredTableCell(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->insertCoveredTableCell(propList);
+}
+
+void PMDLimitedPainter::endTableObject()
+{
+  m_limits.countPainterCall();
+  m_painter->endTableObject();
+}
+
+void PMDLimitedPainter::openOrderedListLevel(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->openOrderedListLevel(propList);
+}
+
+void PMDLimitedPainter::closeOrderedListLevel()
+{
+  m_limits.countPainterCall();
+  m_painter->closeOrderedListLevel();
+}
+
+void PMDLimitedPainter::openUnorderedListLevel(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->openUnorderedListLevel(propList);
+}
+
+void PMDLimitedPainter::closeUnorderedListLevel()
+{
+  m_limits.countPainterCall();
+  m_painter->closeUnorderedListLevel();
+}
+
+void PMDLimitedPainter::openListElement(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->openListElement(propList);
+}
+
+void PMDLimitedPainter::closeListElement()
+{
+  m_limits.countPainterCall();
+  m_painter->closeListElement();
+}
+
+void PMDLimitedPainter::defineParagraphStyle(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->defineParagraphStyle(propList);
+}
+
+void PMDLimitedPainter::openParagraph(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->openParagraph(propList);
+}
+
+void PMDLimitedPainter::closeParagraph()
+{
+  m_limits.countPainterCall();
+  m_painter->closeParagraph();
+}
+
+void PMDLimitedPainter::defineCharacterStyle(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->defineCharacterStyle(propList);
+}
+
+void PMDLimitedPainter::openSpan(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->openSpan(propList);
+}
+
+void PMDLimitedPainter::closeSpan()
+{
+  m_limits.countPainterCall();
+  m_painter->closeSpan();
+}
+
+void PMDLimitedPainter::openLink(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->openLink(propList);
+}
+
+void PMDLimitedPainter::closeLink()
+{
+  m_limits.countPainterCall();
+  m_painter->closeLink();
+}
+
+void PMDLimitedPainter::insertTab()
+{
+  m_limits.countPainterCall();
+  m_painter->insertTab();
+}
+
+void PMDLimitedPainter::insertSpace()
+{
+  m_limits.countPainterCall();
+  m_painter->insertSpace();
+}
+
+void PMDLimitedPainter::insertText(const librevenge::RVNGString &text)
+{
+  m_limits.countPainterCall();
+  m_painter->insertText(text);
+}
+
+void PMDLimitedPainter::insertLineBreak()
+{
+  m_limits.countPainterCall();
+  m_painter->insertLineBreak();
+}
+
+void PMDLimitedPainter::insertField(const librevenge::RVNGPropertyList &propList)
+{
+  m_limits.countPainterCall();
+  m_painter->insertField(propList);
+}
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
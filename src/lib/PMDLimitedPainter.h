@@ -0,0 +1,93 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDLIMITEDPAINTER_H__
+#define __PMDLIMITEDPAINTER_H__
+
+#include <librevenge/librevenge.h>
+
+namespace libpagemaker
+{
+
+class PMDLimits;
+
+/**
+ * Painter that forwards to another painter and counts every call
+ * against the painter call limit and the time limit.
+ */
+class PMDLimitedPainter : public librevenge::RVNGDrawingInterface
+{
+  librevenge::RVNGDrawingInterface *m_painter;
+  PMDLimits &m_limits;
+
+  /* Prevent copy and assignment */
+  PMDLimitedPainter &operator=(const PMDLimitedPainter &);
+  PMDLimitedPainter(const PMDLimitedPainter &);
+
+public:
+  /// Wraps painter, which is not owned.
+  PMDLimitedPainter(librevenge::RVNGDrawingInterface *painter, PMDLimits &limits);
+
+  void startDocument(const librevenge::RVNGPropertyList &propList) override;
+  void endDocument() override;
+  void setDocumentMetaData(const librevenge::RVNGPropertyList &propList) override;
+  void defineEmbeddedFont(const librevenge::RVNGPropertyList &propList) override;
+  void startPage(const librevenge::RVNGPropertyList &propList) override;
+  void endPage() override;
+  void startMasterPage(const librevenge::RVNGPropertyList &propList) override;
+  void endMasterPage() override;
+  void startLayer(const librevenge::RVNGPropertyList &propList) override;
+  void endLayer() override;
+  void startEmbeddedGraphics(const librevenge::RVNGPropertyList &propList) override;
+  void endEmbeddedGraphics() override;
+  void openGroup(const librevenge::RVNGPropertyList &propList) override;
+  void closeGroup() override;
+  void setStyle(const librevenge::RVNGPropertyList &propList) override;
+  void drawRectangle(const librevenge::RVNGPropertyList &propList) override;
+  void drawEllipse(const librevenge::RVNGPropertyList &propList) override;
+  void drawPolyline(const librevenge::RVNGPropertyList &propList) override;
+  void drawPolygon(const librevenge::RVNGPropertyList &propList) override;
+  void drawPath(const librevenge::RVNGPropertyList &propList) override;
+  void drawGraphicObject(const librevenge::RVNGPropertyList &propList) override;
+  void drawConnector(const librevenge::RVNGPropertyList &propList) override;
+  void startTextObject(const librevenge::RVNGPropertyList &propList) override;
+  void endTextObject() override;
+  void startTableObject(const librevenge::RVNGPropertyList &propList) override;
+  void openTableRow(const librevenge::RVNGPropertyList &propList) override;
+  void closeTableRow() override;
+  void openTableCell(const librevenge::RVNGPropertyList &propList) override;
+  void closeTableCell() override;
+  void insertCoveredTableCell(const librevenge::RVNGPropertyList &propList) override;
+  void endTableObject() override;
+  void openOrderedListLevel(const librevenge::RVNGPropertyList &propList) override;
+  void closeOrderedListLevel() override;
+  void openUnorderedListLevel(const librevenge::RVNGPropertyList &propList) override;
+  void closeUnorderedListLevel() override;
+  void openListElement(const librevenge::RVNGPropertyList &propList) override;
+  void closeListElement() override;
+  void defineParagraphStyle(const librevenge::RVNGPropertyList &propList) override;
+  void openParagraph(const librevenge::RVNGPropertyList &propList) override;
+  void closeParagraph() override;
+  void defineCharacterStyle(const librevenge::RVNGPropertyList &propList) override;
+  void openSpan(const librevenge::RVNGPropertyList &propList) override;
+  void closeSpan() override;
+  void openLink(const librevenge::RVNGPropertyList &propList) override;
+  void closeLink() override;
+  void insertTab() override;
+  void insertSpace() override;
+  void insertText(const librevenge::RVNGString &text) override;
+  void insertLineBreak() override;
+  void insertField(const librevenge::RVNGPropertyList &propList) override;
+};
+
+}
+
+#endif /* __PMDLIMITEDPAINTER_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
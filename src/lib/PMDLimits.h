@@ -0,0 +1,111 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDLIMITS_H__
+#define __PMDLIMITS_H__
+
+#include <atomic>
+#include <chrono>
+
+#include <libpagemaker/libpagemaker.h>
+
+#include "PMDExceptions.h"
+
+namespace libpagemaker
+{
+
+/**
+ * Enforces the resource limits of a PMDocument::parse() call.
+ *
+ * The clock of the time limit starts at construction. Every check
+ * throws the matching LimitExceededException, so parsing stops
+ * cooperatively at the next check. Records and bitmaps may be counted
+ * from several threads; painter calls only come from one.
+ */
+class PMDLimits
+{
+  typedef std::chrono::steady_clock Clock_t;
+
+  const bool m_hasDeadline;
+  const Clock_t::time_point m_deadline;
+  const unsigned long m_maxRecords;
+  const unsigned long m_maxBitmapBytes;
+  const unsigned long m_maxPainterCalls;
+  std::atomic<unsigned long> m_bitmapBytes;
+  unsigned long m_painterCalls;
+
+  /* Prevent copy and assignment */
+  PMDLimits &operator=(const PMDLimits &);
+  PMDLimits(const PMDLimits &);
+
+public:
+  /// Reading the clock is cheaper than a record, but not free.
+  static const unsigned long CLOCK_INTERVAL = 64;
+
+  explicit PMDLimits(const PMDParseOptions &options)
+    : m_hasDeadline(options.m_timeLimit != 0),
+      m_deadline(Clock_t::now() + std::chrono::milliseconds(options.m_timeLimit)),
+      m_maxRecords(options.m_maxRecords), m_maxBitmapBytes(options.m_maxBitmapBytes),
+      m_maxPainterCalls(options.m_maxPainterCalls), m_bitmapBytes(0), m_painterCalls(0)
+  { }
+
+  bool limitsPainter() const
+  {
+    return m_hasDeadline || m_maxPainterCalls != 0;
+  }
+
+  bool limitsRecords() const
+  {
+    return m_hasDeadline || m_maxRecords != 0;
+  }
+
+  void checkTime() const
+  {
+    if (m_hasDeadline && Clock_t::now() > m_deadline)
+      throw TimeLimitExceededException();
+  }
+
+  /// Checks the total number of records visited so far.
+  void checkRecords(const unsigned long records) const
+  {
+    if (m_maxRecords != 0 && records > m_maxRecords)
+      throw RecordLimitExceededException();
+    if (records % CLOCK_INTERVAL == 0)
+      checkTime();
+  }
+
+  /// Checks a bitmap before it is read.
+  void checkBitmap(const unsigned long bytes) const
+  {
+    if (m_maxBitmapBytes != 0 && bytes > m_maxBitmapBytes)
+      throw BitmapLimitExceededException();
+  }
+
+  /// Counts the bytes of a bitmap that is output.
+  void addBitmap(const unsigned long bytes)
+  {
+    if (m_maxBitmapBytes != 0 && m_bitmapBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes > m_maxBitmapBytes)
+      throw BitmapLimitExceededException();
+  }
+
+  void countPainterCall()
+  {
+    ++m_painterCalls;
+    if (m_maxPainterCalls != 0 && m_painterCalls > m_maxPainterCalls)
+      throw PainterLimitExceededException();
+    if (m_painterCalls % CLOCK_INTERVAL == 0)
+      checkTime();
+  }
+};
+
+}
+
+#endif /* __PMDLIMITS_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
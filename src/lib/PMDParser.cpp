@@ -10,13 +10,19 @@
 #include "PMDParser.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <exception>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <stdint.h>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
 #include <vector>
 
 #include <boost/iterator/iterator_facade.hpp>
@@ -24,9 +30,14 @@
 
 #include <librevenge/librevenge.h>
 
+#include "PMDAllocationScope.h"
+#include "PMDByteReader.h"
 #include "PMDCollector.h"
 #include "PMDExceptions.h"
 #include "PMDRecord.h"
+#include "PMDRecordLayout.h"
+#include "PMDStats.h"
+#include "PMDStreamByteSource.h"
 #include "PMDTypes.h"
 #include "Units.h"
 #include "constants.h"
@@ -37,41 +48,6 @@
 namespace libpagemaker
 {
 
-namespace
-{
-
-void readDims(librevenge::RVNGInputStream *input, bool bigEndian, int16_t &x, int16_t &y)
-{
-  int16_t dim1 = readS16(input, bigEndian);
-  int16_t dim2 = readS16(input, bigEndian);
-  x = bigEndian ? dim2 : dim1;
-  y = bigEndian ? dim1 : dim2;
-}
-
-boost::optional<PMDStrokeProperties> readRule(librevenge::RVNGInputStream *input, bool bigEndian)
-{
-  const uint16_t flags = readU16(input, bigEndian);
-  if (!(flags & 0x1))
-  {
-    skip(input, 18);
-    return boost::none;
-  }
-
-  PMDStrokeProperties stroke;
-
-  stroke.m_strokeType = readU8(input, bigEndian);
-  skip(input, 1);
-  // FIXME: needs fixing of reading of stroke width elsewhere
-  stroke.m_strokeWidth = uint16_t(readU32(input, bigEndian) >> 8);
-  stroke.m_strokeColor = readU16(input, bigEndian);
-  stroke.m_strokeTint = readU16(input, bigEndian);
-  skip(input, 6);
-
-  return stroke;
-}
-
-}
-
 struct PMDParser::ToCState
 {
   ToCState();
@@ -97,8 +73,7 @@ class PMDParser::RecordIterator :
 {
 public:
   RecordIterator(const RecordContainerList_t &records);
-  RecordIterator(const RecordContainerList_t &records, uint16_t seqNum);
-  RecordIterator(const RecordContainerList_t &records, const RecordTypeMap_t &types, uint16_t recType);
+  RecordIterator(const RecordContainerList_t &records, const RecordIndexList_t &indices);
 
 private:
   friend class boost::iterator_core_access;
@@ -112,53 +87,31 @@ private:
   RecordContainerList_t::const_iterator m_it;
   RecordContainerList_t::const_iterator m_begin;
   RecordContainerList_t::const_iterator m_end;
-  boost::optional<uint16_t> m_selector;
-  boost::optional<RecordTypeMap_t::mapped_type::const_iterator> m_recIt;
-  RecordTypeMap_t::mapped_type::const_iterator m_recBegin;
-  RecordTypeMap_t::mapped_type::const_iterator m_recEnd;
+  boost::optional<RecordIndexList_t::const_iterator> m_recIt;
+  RecordIndexList_t::const_iterator m_recBegin;
+  RecordIndexList_t::const_iterator m_recEnd;
 };
 
 PMDParser::RecordIterator::RecordIterator(const RecordContainerList_t &records)
   : m_it(records.end())
   , m_begin(records.begin())
   , m_end(records.end())
-  , m_selector()
-  , m_recIt()
-  , m_recBegin()
-  , m_recEnd()
-{
-}
-
-PMDParser::RecordIterator::RecordIterator(const RecordContainerList_t &records, const uint16_t seqNum)
-  : m_it(records.begin())
-  , m_begin(records.begin())
-  , m_end(records.end())
-  , m_selector(seqNum)
   , m_recIt()
   , m_recBegin()
   , m_recEnd()
 {
-  increment();
 }
 
-PMDParser::RecordIterator::RecordIterator(const RecordContainerList_t &records, const RecordTypeMap_t &types, const uint16_t recType)
+PMDParser::RecordIterator::RecordIterator(const RecordContainerList_t &records, const RecordIndexList_t &indices)
   : m_it(records.end())
   , m_begin(records.begin())
   , m_end(records.end())
-  , m_selector()
-  , m_recIt()
-  , m_recBegin()
-  , m_recEnd()
+  , m_recIt(indices.begin())
+  , m_recBegin(indices.begin())
+  , m_recEnd(indices.end())
 {
-  const RecordTypeMap_t::const_iterator it = types.find(recType);
-  if (it != types.end())
-  {
-    m_recBegin = it->second.begin();
-    m_recIt = m_recBegin;
-    m_recEnd = it->second.end();
-    if (get(m_recIt) != m_recEnd)
-      m_it = m_begin + *get(m_recIt);
-  }
+  if (get(m_recIt) != m_recEnd)
+    m_it = m_begin + *get(m_recIt);
 }
 
 PMDParser::RecordIterator::reference PMDParser::RecordIterator::dereference() const
@@ -173,16 +126,7 @@ bool PMDParser::RecordIterator::equal(const RecordIterator &other) const
 
 void PMDParser::RecordIterator::increment()
 {
-  if (m_selector)
-  {
-    if (m_it != m_end)
-    {
-      ++m_it;
-      while (m_it != m_end && m_it->m_seqNum != get(m_selector))
-        ++m_it;
-    }
-  }
-  else if (m_recIt && get(m_recIt) != m_recEnd)
+  if (m_recIt && get(m_recIt) != m_recEnd)
   {
     ++get(m_recIt);
     if (get(m_recIt) == m_recEnd)
@@ -194,25 +138,24 @@ void PMDParser::RecordIterator::increment()
 
 void PMDParser::RecordIterator::decrement()
 {
-  if (m_selector)
-  {
-    if (m_it != m_begin)
-    {
-      --m_it;
-      while (m_it != m_begin && m_it->m_seqNum != get(m_selector))
-        --m_it;
-    }
-  }
-  else if (m_recIt && get(m_recIt) != m_recBegin)
+  if (m_recIt && get(m_recIt) != m_recBegin)
   {
     --get(m_recIt);
     m_it = m_begin + *get(m_recIt);
   }
 }
 
+PMDParser::PMDParser(librevenge::RVNGInputStream *input, PMDCollector *collector, const PMDParseOptions &options, PMDLimits *const limits)
+  : m_data(std::make_shared<const std::vector<unsigned char> >(readAll(input))), m_source(), m_input(*m_data), m_length(m_data->size()), m_collector(collector), m_options(options),
+    m_limits(limits), m_work(options.m_workBudget, options.m_work, limits), m_records(), m_recordsBySeqNum(), m_bigEndian(false), m_recordsInOrder(), m_xFormMap(),
+    m_textBlocks(), m_textBlocksOnce(), m_stories(), m_storiesMutex(), m_bitmaps(), m_bitmapsMutex()
+{
+}
+
 PMDParser::PMDParser(librevenge::RVNGInputStream *input, PMDCollector *collector)
-  : m_input(input), m_length(getLength(input)), m_collector(collector),
-    m_records(), m_bigEndian(false), m_recordsInOrder(), m_xFormMap()
+  : m_data(), m_source(new PMDStreamByteSource(input)), m_input(*m_source, getLength(input)), m_length(m_input.length()), m_collector(collector), m_options(),
+    m_limits(0), m_work(0, 0, 0), m_records(), m_recordsBySeqNum(), m_bigEndian(false), m_recordsInOrder(), m_xFormMap(),
+    m_textBlocks(), m_textBlocksOnce(), m_stories(), m_storiesMutex(), m_bitmaps(), m_bitmapsMutex()
 {
 }
 
@@ -229,8 +172,9 @@ const PMDXForm &PMDParser::getXForm(const uint32_t xFormId) const
   return m_xFormMap.find(0)->second;
 }
 
-void seekToRecord(librevenge::RVNGInputStream *const input, const PMDRecordContainer &container, const unsigned recordIndex)
+void PMDParser::seekToRecord(PMDByteReader &input, const PMDRecordContainer &container, const unsigned recordIndex)
 {
+  m_work.visitRecord(input);
   uint32_t recordOffset = container.m_offset;
   if (recordIndex > 0)
   {
@@ -244,129 +188,111 @@ void seekToRecord(librevenge::RVNGInputStream *const input, const PMDRecordConta
   seek(input, recordOffset);
 }
 
-PMDShapePoint readPoint(librevenge::RVNGInputStream *const input, const bool bigEndian)
+template<typename Endian>
+PMDRecordView<Endian> PMDParser::readRecord(PMDByteReader &input, const PMDRecordContainer &container, const unsigned recordIndex, const unsigned recordSize)
 {
-  const PMDShapeUnit x(readS16(input, bigEndian));
-  const PMDShapeUnit y(readS16(input, bigEndian));
-  return bigEndian ? PMDShapePoint(y, x) : PMDShapePoint(x, y);
+  seekToRecord(input, container, recordIndex);
+  // Only the fields that are used need to be present.
+  const unsigned long size = (std::min)(static_cast<unsigned long>(recordSize), input.length() - input.tell());
+  return PMDRecordView<Endian>(readNBytes(input, size), size);
 }
 
+template<typename Endian>
 void PMDParser::parseGlobalInfo(const PMDRecordContainer &container)
 {
-  seekToRecord(m_input, container, 0);
-
-  const unsigned opts = readU8(m_input, m_bigEndian);
+  const PMDRecordView<Endian> record = readRecord<Endian>(m_input, container, 0, GLOBAL_INFO_RECORD_SIZE);
 
-  skip(m_input, 0x35);
+  const unsigned opts = record.get(GlobalInfoRecord::OPTIONS);
 
-  int16_t left = 0;
-  int16_t right = 0;
-  int16_t top = 0;
-  int16_t bottom = 0;
   // FIXME: pass both pages' boundaries to collector instead of computed width/height
-  readDims(m_input, m_bigEndian, left, top);
-  readDims(m_input, m_bigEndian, right, bottom);
+  const PMDShapePoint topLeft = record.get(GlobalInfoRecord::PAGE_TOP_LEFT);
+  const PMDShapePoint botRight = record.get(GlobalInfoRecord::PAGE_BOT_RIGHT);
 
-  m_collector->setDoubleSided(m_bigEndian ? opts & 0x40 : opts & 0x2);
-  m_collector->setPageWidth(right - left);
-  m_collector->setPageHeight(bottom - top);
+  m_collector->setDoubleSided(Endian::IS_BIG ? opts & 0x40 : opts & 0x2);
+  m_collector->setPageWidth(botRight.m_x - topLeft.m_x);
+  m_collector->setPageHeight(botRight.m_y - topLeft.m_y);
 }
 
-void PMDParser::parseLine(const PMDRecordContainer &container, unsigned recordIndex,
-                          unsigned pageID)
+template<typename Endian>
+void PMDParser::parseLine(const PMDRecordView<Endian> &record, unsigned pageID)
 {
-  seekToRecord(m_input, container, recordIndex);
-
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_PARSE_LINE);
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PARSE, PMD_ALLOCATION_SHAPE_LINE);
   PMDStrokeProperties strokeProps;
 
-  skip(m_input, 4);
-  strokeProps.m_strokeColor = readU8(m_input);
-  skip(m_input, 1);
-  PMDShapePoint bboxTopLeft = readPoint(m_input, m_bigEndian);
-  PMDShapePoint bboxBotRight = readPoint(m_input, m_bigEndian);
+  strokeProps.m_strokeColor = record.get(LineShape::STROKE_COLOR);
+  PMDShapePoint bboxTopLeft = record.get(ShapeRecord::BBOX_TOP_LEFT);
+  PMDShapePoint bboxBotRight = record.get(ShapeRecord::BBOX_BOT_RIGHT);
   bool mirrored = false;
-  skip(m_input, 0x18);
-  uint16_t temp = readU16(m_input, m_bigEndian);
+  uint16_t temp = record.get(LineShape::MIRRORED);
 
   if (temp != 257 && temp != 0)
     mirrored = true;
 
-  skip(m_input, 6);
-  strokeProps.m_strokeType = readU8(m_input);
-  skip(m_input, 1);
-  strokeProps.m_strokeWidth =readU16(m_input, m_bigEndian);
-  skip(m_input, 1);
-  strokeProps.m_strokeTint = readU8(m_input);
-  skip(m_input, 6);
-  strokeProps.m_strokeOverprint = readU8(m_input);
+  strokeProps.m_strokeType = record.get(LineShape::STROKE_TYPE);
+  strokeProps.m_strokeWidth = record.get(LineShape::STROKE_WIDTH);
+  strokeProps.m_strokeTint = record.get(LineShape::STROKE_TINT);
+  strokeProps.m_strokeOverprint = record.get(LineShape::STROKE_OVERPRINT);
 
   std::shared_ptr<PMDLineSet> newShape(new PMDLine(bboxTopLeft, bboxBotRight, mirrored, strokeProps));
   m_collector->addShapeToPage(pageID, newShape);
 }
 
-void PMDParser::parseTextBox(const PMDRecordContainer &container, unsigned recordIndex,
-                             unsigned pageID)
+template<typename Endian>
+void PMDParser::parseTextBox(PMDByteReader &input, const PMDRecordView<Endian> &record, unsigned pageID)
 {
-  seekToRecord(m_input, container, recordIndex);
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PARSE, PMD_ALLOCATION_SHAPE_TEXT);
+  // The text blocks are timed as a phase of their own, so they are read
+  // before the text box phase starts.
+  std::call_once(m_textBlocksOnce, [&]()
+  {
+    parseTextBlocks<Endian>(input);
+  });
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_PARSE_TEXT);
+  PMDShapePoint bboxTopLeft = record.get(ShapeRecord::BBOX_TOP_LEFT);
+  PMDShapePoint bboxBotRight = record.get(ShapeRecord::BBOX_BOT_RIGHT);
+
+  uint32_t textBoxXformId = record.get(ShapeRecord::XFORM_ID);
+  uint32_t textBoxTextBlockId = record.get(TextBoxShape::TEXT_BLOCK_ID);
 
-  skip(m_input, 6);
-  PMDShapePoint bboxTopLeft = readPoint(m_input, m_bigEndian);
-  PMDShapePoint bboxBotRight = readPoint(m_input, m_bigEndian);
+  const PMDXForm xFormContainer = getXForm(textBoxXformId);
 
-  uint16_t textBoxTextPropsOne = 0;
-  uint16_t textBoxTextPropsTwo = 0;
-  uint16_t textBoxTextStyle = 0;
   uint16_t textBoxText = 0;
   uint16_t textBoxChars = 0;
   uint16_t textBoxPara = 0;
 
-  skip(m_input, 0xe);
-  uint32_t textBoxXformId = readU32(m_input, m_bigEndian);
-  uint32_t textBoxTextBlockId = readU32(m_input, m_bigEndian);
-
-  const PMDXForm xFormContainer = getXForm(textBoxXformId);
-
-  RecordIterator textBlockIt = beginRecordsOfType(TEXT_BLOCK);
-  if (textBlockIt == endRecords())
+  const auto textBlockIt = m_textBlocks.find(textBoxTextBlockId);
+  if (textBlockIt != m_textBlocks.end())
   {
-    PMD_ERR_MSG("No Text Block Record Found.\n");
+    textBoxText = textBlockIt->second.m_textSeqNum;
+    textBoxChars = textBlockIt->second.m_charsSeqNum;
+    textBoxPara = textBlockIt->second.m_paraSeqNum;
   }
-
-  for (; textBlockIt != endRecords(); ++textBlockIt)
+  else
   {
-    const PMDRecordContainer &textBlockContainer = *textBlockIt;
-
-    for (unsigned i = 0; i < textBlockContainer.m_numRecords; ++i)
-    {
-      seekToRecord(m_input, textBlockContainer, i);
+    PMD_ERR_MSG("Text Block Record Not Found.\n");
+  }
 
-      skip(m_input, 0x20);
-      uint32_t textBlockId = readU32(m_input, m_bigEndian);
+  std::shared_ptr<PMDLineSet> newShape(new PMDTextBox(bboxTopLeft, bboxBotRight, xFormContainer, getStory<Endian>(input, textBoxText, textBoxChars, textBoxPara)));
+  m_collector->addShapeToPage(pageID, newShape);
 
-      if (textBlockId == textBoxTextBlockId)
-      {
-        seekToRecord(m_input, textBlockContainer, i); // return to the beginning of the record
-        textBoxTextPropsOne = readU16(m_input, m_bigEndian);
-        textBoxTextPropsTwo = readU16(m_input, m_bigEndian);
-        textBoxText = readU16(m_input, m_bigEndian);
-        textBoxChars = readU16(m_input, m_bigEndian);
-        textBoxPara = readU16(m_input, m_bigEndian);
-        textBoxTextStyle = readU16(m_input, m_bigEndian);
-
-        (void) textBoxTextPropsOne;
-        (void) textBoxTextPropsTwo;
-        (void) textBoxTextStyle;
-        PMD_DEBUG_MSG(("Text Box Props One is %x \n",textBoxTextPropsOne));
-        PMD_DEBUG_MSG(("Text Box Props Two is %x \n",textBoxTextPropsTwo));
-        PMD_DEBUG_MSG(("Text Box Style is %x \n",textBoxTextStyle));
-        break;
-      }
+}
 
-    }
+template<typename Endian>
+std::shared_ptr<const PMDStory> PMDParser::getStory(PMDByteReader &input, const uint16_t textSeqNum, const uint16_t charsSeqNum, const uint16_t paraSeqNum)
+{
+  const StoryKey_t key(textSeqNum, charsSeqNum, paraSeqNum);
+  {
+    std::lock_guard<std::mutex> lock(m_storiesMutex);
+    const StoryMap_t::const_iterator storyIt = m_stories.find(key);
+    if (storyIt != m_stories.end())
+      return storyIt->second;
   }
-  std::string text = "";
 
-  RecordIterator textIt = beginRecordsWithSeqNumber(textBoxText);
+  std::shared_ptr<PMDStory> story(new PMDStory());
+  std::string &text = story->m_text;
+
+  RecordIterator textIt = beginRecordsWithSeqNumber(textSeqNum);
   if (textIt == endRecords())
   {
     PMD_ERR_MSG("No Text Found.\n");
@@ -375,30 +301,27 @@ void PMDParser::parseTextBox(const PMDRecordContainer &container, unsigned recor
   for (; textIt != endRecords(); ++textIt)
   {
     const PMDRecordContainer &textContainer = *textIt;
-    seekToRecord(m_input, textContainer, 0);
-    for (unsigned i = 0; i < textContainer.m_numRecords; ++i)
-    {
-      text.push_back(readU8(m_input));
-    }
+    seekToRecord(input, textContainer, 0);
+    const unsigned char *const chars = readNBytes(input, textContainer.m_numRecords);
+    text.append(chars, chars + textContainer.m_numRecords);
   }
 
-  std::vector<PMDCharProperties> charProps;
-  for (RecordIterator it = beginRecordsWithSeqNumber(textBoxChars); it != endRecords(); ++it)
+  std::vector<PMDCharProperties> &charProps = story->m_charProps;
+  for (RecordIterator it = beginRecordsWithSeqNumber(charsSeqNum); it != endRecords(); ++it)
   {
     const PMDRecordContainer &charsContainer = *it;
     for (unsigned i = 0; i < charsContainer.m_numRecords; ++i)
     {
-      seekToRecord(m_input, charsContainer, i);
+      const PMDRecordView<Endian> record = readRecord<Endian>(input, charsContainer, i, CHARS_RECORD_SIZE);
 
       charProps.push_back(PMDCharProperties());
       auto &props = charProps.back();
 
-      props.m_length = readU16(m_input, m_bigEndian);
-      props.m_fontFace = readU16(m_input, m_bigEndian);
-      props.m_fontSize = readU16(m_input, m_bigEndian);
-      skip(m_input, 2);
-      props.m_fontColor = readU16(m_input, m_bigEndian);
-      const unsigned flags = readU16(m_input, m_bigEndian);
+      props.m_length = record.get(CharsRecord::LENGTH);
+      props.m_fontFace = record.get(CharsRecord::FONT_FACE);
+      props.m_fontSize = record.get(CharsRecord::FONT_SIZE);
+      props.m_fontColor = record.get(CharsRecord::FONT_COLOR);
+      const unsigned flags = record.get(CharsRecord::FLAGS);
       props.m_bold = flags & 0x1;
       props.m_italic = flags & 0x2;
       props.m_underline = flags & 0x4;
@@ -409,133 +332,101 @@ void PMDParser::parseTextBox(const PMDRecordContainer &container, unsigned recor
       props.m_sub = flags & 0x400;
       props.m_allCaps = flags & 0x800;
       props.m_smallCaps = flags & 0x1000;
-      skip(m_input, 4);
-      props.m_kerning = readS16(m_input, m_bigEndian);
-      skip(m_input, 2);
-      props.m_superSubSize = readU16(m_input, m_bigEndian);
-      props.m_subPos = readU16(m_input, m_bigEndian);
-      props.m_superPos = readU16(m_input, m_bigEndian);
-      skip(m_input, 2);
-      props.m_tint = readU16(m_input, m_bigEndian);
+      props.m_kerning = record.get(CharsRecord::KERNING);
+      props.m_superSubSize = record.get(CharsRecord::SUPER_SUB_SIZE);
+      props.m_subPos = record.get(CharsRecord::SUB_POS);
+      props.m_superPos = record.get(CharsRecord::SUPER_POS);
+      props.m_tint = record.get(CharsRecord::TINT);
     }
   }
 
-  std::vector<PMDParaProperties> paraProps;
-  for (RecordIterator it = beginRecordsWithSeqNumber(textBoxPara); it != endRecords(); ++it)
+  std::vector<PMDParaProperties> &paraProps = story->m_paraProps;
+  for (RecordIterator it = beginRecordsWithSeqNumber(paraSeqNum); it != endRecords(); ++it)
   {
     const PMDRecordContainer &paraContainer = *it;
     for (unsigned i = 0; i < paraContainer.m_numRecords; ++i)
     {
-      seekToRecord(m_input, paraContainer, i);
+      const PMDRecordView<Endian> record = readRecord<Endian>(input, paraContainer, i, PARA_RECORD_SIZE);
 
       paraProps.push_back(PMDParaProperties());
       auto &props = paraProps.back();
 
-      props.m_length = readU16(m_input, m_bigEndian);
-      const unsigned flags = readU8(m_input, m_bigEndian);
+      props.m_length = record.get(ParaRecord::LENGTH);
+      const unsigned flags = record.get(ParaRecord::FLAGS);
       props.m_hyphenate = flags & 0x8;
-      props.m_align = readU8(m_input);
-      skip(m_input, 6);
-      props.m_leftIndent = readU16(m_input, m_bigEndian);
-      props.m_firstIndent = readU16(m_input, m_bigEndian);
-      props.m_rightIndent = readU16(m_input, m_bigEndian);
-      props.m_beforeIndent = readU16(m_input, m_bigEndian); // Above Para Spacing
-      props.m_afterIndent = readU16(m_input, m_bigEndian); // Below Para Spacing
-      skip(m_input, 18);
-      props.m_hyphensCount = readU8(m_input, m_bigEndian);
-      skip(m_input, 1);
-      const unsigned keepOpts = readU16(m_input, m_bigEndian);
+      props.m_align = record.get(ParaRecord::ALIGN);
+      props.m_leftIndent = record.get(ParaRecord::LEFT_INDENT);
+      props.m_firstIndent = record.get(ParaRecord::FIRST_INDENT);
+      props.m_rightIndent = record.get(ParaRecord::RIGHT_INDENT);
+      props.m_beforeIndent = record.get(ParaRecord::BEFORE_INDENT); // Above Para Spacing
+      props.m_afterIndent = record.get(ParaRecord::AFTER_INDENT); // Below Para Spacing
+      props.m_hyphensCount = record.get(ParaRecord::HYPHENS_COUNT);
+      const unsigned keepOpts = record.get(ParaRecord::KEEP_OPTIONS);
       props.m_keepTogether = keepOpts & 0x1;
       props.m_keepWithNext = (keepOpts >> 1) & 0x3;
       props.m_widows = (keepOpts >> 4) & 0x3;
       props.m_orphans = (keepOpts >> 7) & 0x3;
-      skip(m_input, 2);
-      props.m_ruleAbove = readRule(m_input, m_bigEndian);
-      props.m_ruleBelow = readRule(m_input, m_bigEndian);
+      props.m_ruleAbove = record.get(ParaRecord::RULE_ABOVE);
+      props.m_ruleBelow = record.get(ParaRecord::RULE_BELOW);
     }
   }
 
-  std::shared_ptr<PMDLineSet> newShape(new PMDTextBox(bboxTopLeft, bboxBotRight, xFormContainer, text, charProps, paraProps));
-  m_collector->addShapeToPage(pageID, newShape);
-
+  // Another page may have decoded the same story meanwhile. Keep the first.
+  std::lock_guard<std::mutex> lock(m_storiesMutex);
+  return m_stories.insert(StoryMap_t::value_type(key, story)).first->second;
 }
 
-void PMDParser::parseRectangle(const PMDRecordContainer &container, unsigned recordIndex,
-                               unsigned pageID)
+template<typename Endian>
+void PMDParser::parseRectangle(const PMDRecordView<Endian> &record, unsigned pageID)
 {
-  seekToRecord(m_input, container, recordIndex);
-
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_PARSE_RECTANGLE);
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PARSE, PMD_ALLOCATION_SHAPE_RECTANGLE);
   PMDFillProperties fillProps;
   PMDStrokeProperties strokeProps;
 
-  skip(m_input, 2);
-  fillProps.m_fillOverprint = readU8(m_input);
-  skip(m_input, 1);
-  fillProps.m_fillColor = readU8(m_input);
-  skip(m_input, 1);
-  PMDShapePoint bboxTopLeft = readPoint(m_input, m_bigEndian);
-  PMDShapePoint bboxBotRight = readPoint(m_input, m_bigEndian);
-  skip(m_input, 14);
-  uint32_t rectXformId = readU32(m_input, m_bigEndian);
-
-  strokeProps.m_strokeType = readU8(m_input);
-  skip(m_input, 2);
-  strokeProps.m_strokeWidth = readU16(m_input, m_bigEndian);
-  skip(m_input, 1);
-  fillProps.m_fillType = readU8(m_input);
-  skip(m_input, 1);
-  strokeProps.m_strokeColor = readU8(m_input);
-  skip(m_input, 1);
-  strokeProps.m_strokeOverprint = readU8(m_input);
-  skip(m_input, 1);
-  strokeProps.m_strokeTint = readU8(m_input);
+  fillProps.m_fillOverprint = record.get(FilledShape::FILL_OVERPRINT);
+  fillProps.m_fillColor = record.get(FilledShape::FILL_COLOR);
+  PMDShapePoint bboxTopLeft = record.get(ShapeRecord::BBOX_TOP_LEFT);
+  PMDShapePoint bboxBotRight = record.get(ShapeRecord::BBOX_BOT_RIGHT);
+  uint32_t rectXformId = record.get(ShapeRecord::XFORM_ID);
 
-  skip(m_input, 0xb3);
-  fillProps.m_fillTint = readU8(m_input);
+  strokeProps.m_strokeType = record.get(FilledShape::STROKE_TYPE);
+  strokeProps.m_strokeWidth = record.get(FilledShape::STROKE_WIDTH);
+  fillProps.m_fillType = record.get(FilledShape::FILL_TYPE);
+  strokeProps.m_strokeColor = record.get(FilledShape::STROKE_COLOR);
+  strokeProps.m_strokeOverprint = record.get(FilledShape::STROKE_OVERPRINT);
+  strokeProps.m_strokeTint = record.get(FilledShape::STROKE_TINT);
+  fillProps.m_fillTint = record.get(FilledShape::FILL_TINT);
 
   const PMDXForm &xFormContainer = getXForm(rectXformId);
   std::shared_ptr<PMDLineSet> newShape(new PMDRectangle(bboxTopLeft, bboxBotRight, xFormContainer, fillProps, strokeProps));
   m_collector->addShapeToPage(pageID, newShape);
 }
 
-void PMDParser::parsePolygon(const PMDRecordContainer &container, unsigned recordIndex,
-                             unsigned pageID)
+template<typename Endian>
+void PMDParser::parsePolygon(PMDByteReader &input, const PMDRecordView<Endian> &record, unsigned pageID)
 {
-  seekToRecord(m_input, container, recordIndex);
-
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_PARSE_POLYGON);
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PARSE, PMD_ALLOCATION_SHAPE_POLYGON);
   PMDFillProperties fillProps;
   PMDStrokeProperties strokeProps;
 
-  skip(m_input, 2);
-  fillProps.m_fillOverprint = readU8(m_input);
-  skip(m_input, 1);
-  fillProps.m_fillColor = readU8(m_input);
-
-  skip(m_input, 1);
-  PMDShapePoint bboxTopLeft = readPoint(m_input, m_bigEndian);
-  PMDShapePoint bboxBotRight = readPoint(m_input, m_bigEndian);
-
-  skip(m_input, 14);
-  uint32_t polyXformId = readU32(m_input, m_bigEndian);
+  fillProps.m_fillOverprint = record.get(FilledShape::FILL_OVERPRINT);
+  fillProps.m_fillColor = record.get(FilledShape::FILL_COLOR);
+  PMDShapePoint bboxTopLeft = record.get(ShapeRecord::BBOX_TOP_LEFT);
+  PMDShapePoint bboxBotRight = record.get(ShapeRecord::BBOX_BOT_RIGHT);
+  uint32_t polyXformId = record.get(ShapeRecord::XFORM_ID);
 
-  strokeProps.m_strokeType = readU8(m_input);
-  skip(m_input, 2);
-  strokeProps.m_strokeWidth = readU16(m_input, m_bigEndian);
-  skip(m_input, 1);
-  fillProps.m_fillType = readU8(m_input);
-  skip(m_input, 1);
-  strokeProps.m_strokeColor = readU8(m_input);
-  skip(m_input, 1);
-  strokeProps.m_strokeOverprint = readU8(m_input);
-  skip(m_input, 1);
-  strokeProps.m_strokeTint = readU8(m_input);
+  strokeProps.m_strokeType = record.get(FilledShape::STROKE_TYPE);
+  strokeProps.m_strokeWidth = record.get(FilledShape::STROKE_WIDTH);
+  fillProps.m_fillType = record.get(FilledShape::FILL_TYPE);
+  strokeProps.m_strokeColor = record.get(FilledShape::STROKE_COLOR);
+  strokeProps.m_strokeOverprint = record.get(FilledShape::STROKE_OVERPRINT);
+  strokeProps.m_strokeTint = record.get(FilledShape::STROKE_TINT);
 
-  skip(m_input, 1);
-  uint16_t lineSetSeqNum = readU16(m_input, m_bigEndian);
-  skip(m_input, 8);
-  uint8_t closedMarker = readU8(m_input);
-  skip(m_input, 0xa7);
-  fillProps.m_fillTint = readU8(m_input);
+  uint16_t lineSetSeqNum = record.get(PolygonShape::LINE_SET_SEQ_NUM);
+  uint8_t closedMarker = record.get(PolygonShape::CLOSED_MARKER);
+  fillProps.m_fillTint = record.get(FilledShape::FILL_TINT);
 
   bool closed;
   switch (closedMarker)
@@ -558,11 +449,9 @@ void PMDParser::parsePolygon(const PMDRecordContainer &container, unsigned recor
   for (RecordIterator it = beginRecordsWithSeqNumber(lineSetSeqNum); it != endRecords(); ++it)
   {
     const PMDRecordContainer &lineSetContainer = *it;
-    for (unsigned i = 0; i < lineSetContainer.m_numRecords; ++i)
-    {
-      seekToRecord(m_input, lineSetContainer, i);
-      points.push_back(readPoint(m_input, m_bigEndian));
-    }
+    seekToRecord(input, lineSetContainer, 0);
+    const unsigned char *const data = readNBytes(input, lineSetContainer.m_numRecords * LINE_SET_RECORD_SIZE);
+    readPoints<Endian>(data, lineSetContainer.m_numRecords, points);
   }
 
   const PMDXForm &xFormContainer = getXForm(polyXformId);
@@ -570,58 +459,73 @@ void PMDParser::parsePolygon(const PMDRecordContainer &container, unsigned recor
   m_collector->addShapeToPage(pageID, newShape);
 }
 
-void PMDParser::parseEllipse(const PMDRecordContainer &container, unsigned recordIndex, unsigned pageID)
+template<typename Endian>
+void PMDParser::parseEllipse(const PMDRecordView<Endian> &record, unsigned pageID)
 {
-  seekToRecord(m_input, container, recordIndex);
-
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_PARSE_ELLIPSE);
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PARSE, PMD_ALLOCATION_SHAPE_ELLIPSE);
   PMDFillProperties fillProps;
   PMDStrokeProperties strokeProps;
 
-  skip(m_input, 2);
-  fillProps.m_fillOverprint = readU8(m_input);
-  skip(m_input, 1);
-  fillProps.m_fillColor = readU8(m_input);
-
-  skip(m_input, 1);
-  PMDShapePoint bboxTopLeft = readPoint(m_input, m_bigEndian);
-  PMDShapePoint bboxBotRight = readPoint(m_input, m_bigEndian);
-
-  skip(m_input, 14);
-  uint32_t ellipseXformId = readU32(m_input, m_bigEndian);
-
-  strokeProps.m_strokeType = readU8(m_input);
-  skip(m_input, 2);
-  strokeProps.m_strokeWidth = readU16(m_input, m_bigEndian);
-  skip(m_input, 1);
-  fillProps.m_fillType = readU8(m_input);
-  skip(m_input, 1);
-  strokeProps.m_strokeColor = readU8(m_input);
-  skip(m_input, 1);
-  strokeProps.m_strokeOverprint = readU8(m_input);
-  skip(m_input, 1);
-  strokeProps.m_strokeTint = readU8(m_input);
+  fillProps.m_fillOverprint = record.get(FilledShape::FILL_OVERPRINT);
+  fillProps.m_fillColor = record.get(FilledShape::FILL_COLOR);
+  PMDShapePoint bboxTopLeft = record.get(ShapeRecord::BBOX_TOP_LEFT);
+  PMDShapePoint bboxBotRight = record.get(ShapeRecord::BBOX_BOT_RIGHT);
+  uint32_t ellipseXformId = record.get(ShapeRecord::XFORM_ID);
 
-  skip(m_input, 0xb3);
-  fillProps.m_fillTint = readU8(m_input);
+  strokeProps.m_strokeType = record.get(FilledShape::STROKE_TYPE);
+  strokeProps.m_strokeWidth = record.get(FilledShape::STROKE_WIDTH);
+  fillProps.m_fillType = record.get(FilledShape::FILL_TYPE);
+  strokeProps.m_strokeColor = record.get(FilledShape::STROKE_COLOR);
+  strokeProps.m_strokeOverprint = record.get(FilledShape::STROKE_OVERPRINT);
+  strokeProps.m_strokeTint = record.get(FilledShape::STROKE_TINT);
+  fillProps.m_fillTint = record.get(FilledShape::FILL_TINT);
 
   const PMDXForm &xFormContainer = getXForm(ellipseXformId);
   std::shared_ptr<PMDLineSet> newShape(new PMDEllipse(bboxTopLeft, bboxBotRight, xFormContainer, fillProps, strokeProps));
   m_collector->addShapeToPage(pageID, newShape);
 }
 
-void PMDParser::parseBitmap(const PMDRecordContainer &container, unsigned recordIndex, unsigned pageID)
+std::shared_ptr<const PMDBitmapSource> PMDParser::getUniqueBitmap(const std::shared_ptr<const PMDBitmapSource> &bitmap)
 {
-  librevenge::RVNGBinaryData bitmap;
-  seekToRecord(m_input, container, recordIndex);
+  // Without an image sink, every occurrence is embedded anyway, so
+  // finding the repeated ones would only cost time.
+  if (!m_options.m_imageSink)
+  {
+    if (m_limits)
+      m_limits->addBitmap(bitmap->size());
+    return bitmap;
+  }
 
-  skip(m_input, 6);
-  PMDShapePoint bboxTopLeft = readPoint(m_input, m_bigEndian);
-  PMDShapePoint bboxBotRight = readPoint(m_input, m_bigEndian);
-  skip(m_input, 14);
-  uint32_t bboxXformId = readU32(m_input, m_bigEndian);
+  // Repeated images, like a logo on every page, share the first instance.
+  if (m_limits)
+    m_limits->checkBitmap(bitmap->size());
+  const uint64_t hash = bitmap->hash();
+  std::lock_guard<std::mutex> lock(m_bitmapsMutex);
+  const auto range = m_bitmaps.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it)
+  {
+    if (it->second->hasSameContent(*bitmap))
+      return it->second;
+  }
+  if (m_limits)
+    m_limits->addBitmap(bitmap->size());
+  m_bitmaps.insert(BitmapMap_t::value_type(hash, bitmap));
+  return bitmap;
+}
+
+template<typename Endian>
+void PMDParser::parseBitmap(PMDByteReader &input, const PMDRecordView<Endian> &record, unsigned pageID)
+{
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_PARSE_BITMAP);
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PARSE, PMD_ALLOCATION_SHAPE_BITMAP);
+  std::shared_ptr<PMDBitmapSource> bitmap(new PMDBitmapSource(m_data));
+
+  PMDShapePoint bboxTopLeft = record.get(ShapeRecord::BBOX_TOP_LEFT);
+  PMDShapePoint bboxBotRight = record.get(ShapeRecord::BBOX_BOT_RIGHT);
+  uint32_t bboxXformId = record.get(ShapeRecord::XFORM_ID);
 
-  skip(m_input, 16);
-  uint16_t bitmapRecordSeqNum = readU16(m_input, m_bigEndian);
+  uint16_t bitmapRecordSeqNum = record.get(BitmapShape::TIFF_SEQ_NUM);
 
   const PMDXForm &xFormContainer = getXForm(bboxXformId);
 
@@ -634,9 +538,9 @@ void PMDParser::parseBitmap(const PMDRecordContainer &container, unsigned record
   for (; tiffIt != endRecords(); ++tiffIt)
   {
     const PMDRecordContainer &tiffContainer = *tiffIt;
-    seekToRecord(m_input, tiffContainer, 0);
-    const unsigned char *const tempBytes = readNBytes(m_input,tiffContainer.m_numRecords);
-    bitmap.append(tempBytes,tiffContainer.m_numRecords);
+    seekToRecord(input, tiffContainer, 0);
+    bitmap->m_chunks.push_back(std::make_pair(input.tell(), (unsigned long) tiffContainer.m_numRecords));
+    skip(input, tiffContainer.m_numRecords);
   }
 
   tiffIt = beginRecordsWithSeqNumber(bitmapRecordSeqNum + 1);
@@ -647,18 +551,38 @@ void PMDParser::parseBitmap(const PMDRecordContainer &container, unsigned record
   for (; tiffIt != endRecords(); ++tiffIt)
   {
     const PMDRecordContainer &tiffSecondContainer = *tiffIt;
-    seekToRecord(m_input, tiffSecondContainer, 0);
-    const unsigned char *const tempBytes = readNBytes(m_input,tiffSecondContainer.m_numRecords);
-    bitmap.append(tempBytes,tiffSecondContainer.m_numRecords);
+    seekToRecord(input, tiffSecondContainer, 0);
+    bitmap->m_chunks.push_back(std::make_pair(input.tell(), (unsigned long) tiffSecondContainer.m_numRecords));
+    skip(input, tiffSecondContainer.m_numRecords);
   }
 
 
-  std::shared_ptr<PMDLineSet> newShape(new PMDBitmap(bboxTopLeft, bboxBotRight, xFormContainer, bitmap));
+  std::shared_ptr<PMDLineSet> newShape(new PMDBitmap(bboxTopLeft, bboxBotRight, xFormContainer, getUniqueBitmap(bitmap)));
   m_collector->addShapeToPage(pageID, newShape);
 
 }
 
-void PMDParser::parseShapes(uint16_t seqNum, unsigned pageID)
+bool PMDParser::isShapeWanted(const uint8_t shapeType) const
+{
+  switch (shapeType)
+  {
+  case LINE_RECORD:
+  case RECTANGLE_RECORD:
+  case POLYGON_RECORD:
+  case ELLIPSE_RECORD:
+    return m_options.m_content & PMD_CONTENT_GRAPHICS;
+  case TEXT_RECORD:
+    return m_options.m_content & PMD_CONTENT_TEXT;
+  case BITMAP_RECORD:
+  case METAFILE_RECORD:
+    return m_options.m_content & PMD_CONTENT_BITMAPS;
+  default:
+    return true;
+  }
+}
+
+template<typename Endian>
+void PMDParser::parseShapes(PMDByteReader &input, uint16_t seqNum, unsigned pageID)
 {
   for (RecordIterator it = beginRecordsWithSeqNumber(seqNum); it != endRecords(); ++it)
   {
@@ -666,29 +590,31 @@ void PMDParser::parseShapes(uint16_t seqNum, unsigned pageID)
 
     for (unsigned i = 0; i < container.m_numRecords; ++i)
     {
-      seekToRecord(m_input, container, i);
+      const PMDRecordView<Endian> record = readRecord<Endian>(input, container, i, SHAPE_RECORD_SIZE);
 
-      uint8_t shapeType = readU8(m_input);
+      uint8_t shapeType = record.get(ShapeRecord::TYPE);
+      if (!isShapeWanted(shapeType))
+        continue;
       switch (shapeType)
       {
       case LINE_RECORD:
-        parseLine(container, i, pageID);
+        parseLine(record, pageID);
         break;
       case RECTANGLE_RECORD:
-        parseRectangle(container, i, pageID);
+        parseRectangle(record, pageID);
         break;
       case POLYGON_RECORD:
-        parsePolygon(container, i, pageID);
+        parsePolygon(input, record, pageID);
         break;
       case ELLIPSE_RECORD:
-        parseEllipse(container, i, pageID);
+        parseEllipse(record, pageID);
         break;
       case TEXT_RECORD:
-        parseTextBox(container, i, pageID);
+        parseTextBox(input, record, pageID);
         break;
       case BITMAP_RECORD:
       case METAFILE_RECORD:
-        parseBitmap(container, i, pageID);
+        parseBitmap(input, record, pageID);
         break;
       default:
         PMD_ERR_MSG("Encountered shape of unknown type.\n");
@@ -696,10 +622,12 @@ void PMDParser::parseShapes(uint16_t seqNum, unsigned pageID)
       }
     }
   }
+  m_work.collect(input);
 }
 
 void PMDParser::parseFonts()
 {
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_FONTS);
   RecordIterator it = beginRecordsOfType(FONTS);
 
   if (it != endRecords())
@@ -731,8 +659,10 @@ void PMDParser::parseFonts()
   }
 }
 
+template<typename Endian>
 void PMDParser::parseColors()
 {
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_COLORS);
   RecordIterator it = beginRecordsOfType(COLORS);
 
   if (it != endRecords())
@@ -746,27 +676,25 @@ void PMDParser::parseColors()
 
     for (unsigned i = 0; i < container.m_numRecords; ++i)
     {
-      seekToRecord(m_input, container, i);
-      skip(m_input, 0x22);
+      const PMDRecordView<Endian> record = readRecord<Endian>(m_input, container, i, COLORS_RECORD_SIZE);
 
-      uint8_t colorModel = readU8(m_input);
+      uint8_t colorModel = record.get(ColorRecord::MODEL);
       uint8_t red = 0;
       uint8_t blue = 0;
       uint8_t green = 0;
 
-      skip(m_input, 3);
       if (colorModel == RGB)
       {
-        red = readU8(m_input);
-        green = readU8(m_input);
-        blue = readU8(m_input);
+        red = record.get(ColorRecord::RED);
+        green = record.get(ColorRecord::GREEN);
+        blue = record.get(ColorRecord::BLUE);
       }
       else if (colorModel == CMYK || colorModel == HLS) // HLS is also stroed in CMYK format
       {
-        uint16_t cyan = readU16(m_input, m_bigEndian);
-        uint16_t magenta = readU16(m_input, m_bigEndian);
-        uint16_t yellow = readU16(m_input, m_bigEndian);
-        uint16_t black = readU16(m_input, m_bigEndian);
+        uint16_t cyan = record.get(ColorRecord::CYAN);
+        uint16_t magenta = record.get(ColorRecord::MAGENTA);
+        uint16_t yellow = record.get(ColorRecord::YELLOW);
+        uint16_t black = record.get(ColorRecord::BLACK);
 
         uint16_t max = (std::numeric_limits<uint16_t>::max)();
 
@@ -780,8 +708,10 @@ void PMDParser::parseColors()
   }
 }
 
+template<typename Endian>
 void PMDParser::parseXforms()
 {
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_XFORMS);
   RecordIterator it = beginRecordsOfType(XFORM);
 
   for (; it != endRecords(); ++it)
@@ -790,16 +720,14 @@ void PMDParser::parseXforms()
 
     for (unsigned i = 0; i < xformContainer.m_numRecords; ++i)
     {
+      const PMDRecordView<Endian> record = readRecord<Endian>(m_input, xformContainer, i, XFORM_RECORD_SIZE);
 
-      seekToRecord(m_input, xformContainer, i);
-
-      uint32_t rotationDegree = readU32(m_input, m_bigEndian);
-      uint32_t skewDegree = readU32(m_input, m_bigEndian);
-      skip(m_input, 2);
-      PMDShapePoint xformTopLeft = readPoint(m_input, m_bigEndian);
-      PMDShapePoint xformBotRight = readPoint(m_input, m_bigEndian);
-      PMDShapePoint rotatingPoint = readPoint(m_input, m_bigEndian);
-      uint32_t xformId = readU32(m_input, m_bigEndian);
+      uint32_t rotationDegree = record.get(XFormRecord::ROTATION);
+      uint32_t skewDegree = record.get(XFormRecord::SKEW);
+      PMDShapePoint xformTopLeft = record.get(XFormRecord::TOP_LEFT);
+      PMDShapePoint xformBotRight = record.get(XFormRecord::BOT_RIGHT);
+      PMDShapePoint rotatingPoint = record.get(XFormRecord::ROTATING_POINT);
+      uint32_t xformId = record.get(XFormRecord::ID);
 
       m_xFormMap.insert(std::pair<uint32_t, PMDXForm>(xformId,PMDXForm(rotationDegree,skewDegree,xformTopLeft,xformBotRight,rotatingPoint,xformId)));
     }
@@ -807,31 +735,187 @@ void PMDParser::parseXforms()
   m_xFormMap.insert(std::pair<uint32_t,PMDXForm>(0,PMDXForm(0,0,PMDShapePoint(0,0),PMDShapePoint(0,0),PMDShapePoint(0,0),0))); //Default XForm
 }
 
+template<typename Endian>
+void PMDParser::parseTextBlocks(PMDByteReader &input)
+{
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_TEXT_BLOCKS);
+  RecordIterator it = beginRecordsOfType(TEXT_BLOCK);
+
+  if (it == endRecords())
+  {
+    PMD_ERR_MSG("No Text Block Record Found.\n");
+  }
+
+  for (; it != endRecords(); ++it)
+  {
+    const PMDRecordContainer &textBlockContainer = *it;
+
+    // If an ID is repeated, the first record in a container and the last
+    // container wins. Hence the backward iteration.
+    for (unsigned i = textBlockContainer.m_numRecords; i > 0; --i)
+    {
+      const PMDRecordView<Endian> record = readRecord<Endian>(input, textBlockContainer, i - 1, TEXT_BLOCK_RECORD_SIZE);
+
+      const uint16_t textPropsOne = record.get(TextBlockRecord::PROPS_ONE);
+      const uint16_t textPropsTwo = record.get(TextBlockRecord::PROPS_TWO);
+      TextBlock textBlock;
+      textBlock.m_textSeqNum = record.get(TextBlockRecord::TEXT_SEQ_NUM);
+      textBlock.m_charsSeqNum = record.get(TextBlockRecord::CHARS_SEQ_NUM);
+      textBlock.m_paraSeqNum = record.get(TextBlockRecord::PARA_SEQ_NUM);
+      const uint16_t textStyle = record.get(TextBlockRecord::STYLE);
+      const uint32_t textBlockId = record.get(TextBlockRecord::ID);
+
+      (void) textPropsOne;
+      (void) textPropsTwo;
+      (void) textStyle;
+      PMD_DEBUG_MSG(("Text Block %x: Props One is %x, Props Two is %x, Style is %x\n", textBlockId, textPropsOne, textPropsTwo, textStyle));
+
+      m_textBlocks[textBlockId] = textBlock;
+    }
+  }
+}
+
 
+template<typename Endian>
 void PMDParser::parsePages(const PMDRecordContainer &container)
 {
-  seekToRecord(m_input, container, 0);
-
-  skip(m_input, 8);
-  uint16_t pageWidth = readU16(m_input, m_bigEndian);
+  uint16_t pageWidth = readRecord<Endian>(m_input, container, 0, PAGE_RECORD_SIZE).get(PageRecord::WIDTH);
   (void) pageWidth;
 
   // if (pageWidth)
   // m_collector->setPageWidth(pageWidth);
 
+  std::vector<PageShapes> pages;
   for (unsigned i = 0; i < container.m_numRecords; ++i)
   {
-    seekToRecord(m_input, container, i);
+    PageShapes page;
+    page.m_pageID = m_collector->addPage();
+    if (!m_collector->isPageUsed(page.m_pageID))
+      continue;
+    page.m_shapesSeqNum = readRecord<Endian>(m_input, container, i, PAGE_RECORD_SIZE).get(PageRecord::SHAPES_SEQ_NUM);
+    pages.push_back(page);
+  }
+  if (PMDProgressReporter *const progress = m_collector->getProgress())
+    progress->setPageCounts(pages.size(), m_collector->countOutputPages());
+
+  unsigned threads = m_options.m_threads;
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+
+  if (!m_options.m_streaming)
+  {
+    parsePageShapes<Endian>(pages, threads);
+    return;
+  }
 
-    skip(m_input, 2);
-    uint16_t shapesSeqNum = readU16(m_input, m_bigEndian);
-    unsigned pageID = m_collector->addPage();
-    parseShapes(shapesSeqNum, pageID);
+  // Decode one page per thread at a time and hand the finished pages
+  // over to the collector before decoding more.
+  const std::size_t batchSize = (std::max)(threads, 1u);
+  unsigned completedPages = 0;
+  for (std::size_t begin = 0; begin < pages.size(); begin += batchSize)
+  {
+    const std::size_t end = (std::min)(begin + batchSize, pages.size());
+    parsePageShapes<Endian>(std::vector<PageShapes>(pages.begin() + begin, pages.begin() + end), threads);
+    for (; completedPages <= pages[end - 1].m_pageID; ++completedPages)
+      m_collector->pageComplete(completedPages);
   }
+  for (; completedPages < container.m_numRecords; ++completedPages)
+    m_collector->pageComplete(completedPages);
+}
+
+template<typename Endian>
+void PMDParser::parsePageShapes(const std::vector<PageShapes> &pages, unsigned threads)
+{
+  if (threads > pages.size())
+    threads = pages.size();
+
+  PMDProgressReporter *const progress = m_collector->getProgress();
+  if (threads <= 1)
+  {
+    for (const auto &page : pages)
+    {
+      parseShapes<Endian>(m_input, page.m_shapesSeqNum, page.m_pageID);
+      if (progress)
+        progress->pageDecoded();
+    }
+    return;
+  }
+
+  // All pages have been added to the collector already, so every worker
+  // only ever appends to the pages it has taken. The workers take the
+  // next undecoded page whenever they are done with one, which balances
+  // pages of very different cost.
+  std::atomic<std::size_t> nextPage(0);
+  std::vector<std::exception_ptr> errors(pages.size());
+
+  const auto worker = [&]()
+  {
+    PMDByteReader input(*m_data);
+    for (std::size_t i = nextPage++; i < pages.size(); i = nextPage++)
+    {
+      try
+      {
+        parseShapes<Endian>(input, pages[i].m_shapesSeqNum, pages[i].m_pageID);
+        if (progress)
+          progress->pageDecoded();
+      }
+      catch (...)
+      {
+        errors[i] = std::current_exception();
+        // Parsing fails anyway, so let all workers stop after their current page.
+        nextPage = pages.size();
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  try
+  {
+    for (unsigned i = 1; i < threads; ++i)
+      workers.push_back(std::thread(worker));
+  }
+  catch (const std::system_error &)
+  {
+    // The pages are shared out dynamically, so the threads that did
+    // start (at least this one) decode all of them.
+  }
+  worker();
+  for (auto &thread : workers)
+    thread.join();
+
+  // A cancellation or an exceeded limit is the reason why the other
+  // workers stopped, so it is reported before any ordinary parse error.
+  std::exception_ptr parseError;
+  for (const auto &error : errors)
+  {
+    if (!error)
+      continue;
+    try
+    {
+      std::rethrow_exception(error);
+    }
+    catch (const CancelledException &)
+    {
+      throw;
+    }
+    catch (const LimitExceededException &)
+    {
+      throw;
+    }
+    catch (...)
+    {
+      if (!parseError)
+        parseError = error;
+    }
+  }
+  if (parseError)
+    std::rethrow_exception(parseError);
 }
 
 void PMDParser::parseHeader(uint32_t *tocOffset, uint16_t *tocLength)
 {
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_HEADER);
   PMD_DEBUG_MSG(("[Header] Parsing header...\n"));
   seek(m_input, ENDIANNESS_MARKER_OFFSET);
   uint16_t endiannessMarker = readU16(m_input, false);
@@ -873,6 +957,7 @@ void PMDParser::parseHeader(uint32_t *tocOffset, uint16_t *tocLength)
 
 void PMDParser::readNextRecordFromTableOfContents(ToCState &state, const bool subRecord, const uint16_t subRecordType)
 {
+  m_work.visitRecord(m_input);
   skip(m_input, 1);
   uint16_t recType = readU8(m_input);
   uint16_t numRecs = readU16(m_input, m_bigEndian);
@@ -918,6 +1003,11 @@ void PMDParser::readNextRecordFromTableOfContents(ToCState &state, const bool su
       }
       m_recordsInOrder.push_back(PMDRecordContainer(recType, offset, state.seqNum, numRecs));
       m_records[recType].push_back((unsigned)(m_recordsInOrder.size() - 1));
+      // The first record (GLOBAL_INFO in any sane file) is never
+      // looked up by seqNum. Zeroed references, e.g., of a text box whose
+      // text block is missing, must not resolve to it.
+      if (m_recordsInOrder.size() > 1)
+        m_recordsBySeqNum[state.seqNum].push_back((unsigned)(m_recordsInOrder.size() - 1));
     }
     if (!subRecord)
       ++state.seqNum;
@@ -926,13 +1016,13 @@ void PMDParser::readNextRecordFromTableOfContents(ToCState &state, const bool su
 
 void PMDParser::readTableOfContents(ToCState &state, const uint32_t offset, unsigned records, const bool subRecords, const uint16_t subRecordType)
 {
-  if (state.parsedBlocks.end() != state.parsedBlocks.find(m_input->tell()))
+  if (state.parsedBlocks.end() != state.parsedBlocks.find(m_input.tell()))
   {
-    PMD_DEBUG_MSG(("[TOC] ToC block at offset %ld has already been read. The file is probably broken. Skipping...\n", m_input->tell()));
+    PMD_DEBUG_MSG(("[TOC] ToC block at offset %ld has already been read. The file is probably broken. Skipping...\n", m_input.tell()));
     return;
   }
 
-  state.parsedBlocks.insert(m_input->tell());
+  state.parsedBlocks.insert(m_input.tell());
 
   if (records == 0 || offset == 0)
   {
@@ -940,7 +1030,7 @@ void PMDParser::readTableOfContents(ToCState &state, const uint32_t offset, unsi
     return;
   }
 
-  const long orig = m_input->tell();
+  const long orig = m_input.tell();
 
   PMD_DEBUG_MSG(("[TOC] reading %sblock at offset 0x%x\n", subRecords ? "subrecord " : "", offset));
   seek(m_input, offset);
@@ -955,55 +1045,126 @@ void PMDParser::readTableOfContents(ToCState &state, const uint32_t offset, unsi
 
 void PMDParser::parseTableOfContents(uint32_t offset, uint16_t length) try
 {
+  PMD_TIME_PHASE(m_collector->getStats(), PMD_PHASE_TOC);
   ToCState state;
   readTableOfContents(state, offset, length, false);
 }
+catch (const CancelledException &)
+{
+  throw;
+}
+catch (const LimitExceededException &)
+{
+  throw;
+}
 catch (...)
 {
   PMD_ERR_MSG("Error reading the table of contents! Some or all records will be missing.\n");
 }
 
 void PMDParser::parse()
+{
+  uint32_t tocOffset;
+  uint16_t tocLength;
+  m_collector->setPageRange(m_options.m_firstPage, m_options.m_lastPage);
+  m_collector->setImageSink(m_options.m_imageSink);
+  if (m_options.m_stats)
+    m_collector->enableStats();
+  if (m_options.m_progress)
+    m_collector->enableProgress(m_options.m_progress);
+  parseHeader(&tocOffset, &tocLength);
+  parseTableOfContents(tocOffset, tocLength);
+  if (PMDProgressReporter *const progress = m_collector->getProgress())
+    progress->tableOfContentsRead();
+  parseFonts();
+
+  if (m_bigEndian)
+    parseRecords<PMDBigEndian>();
+  else
+    parseRecords<PMDLittleEndian>();
+  m_work.collect(m_input);
+}
+
+unsigned PMDParser::parseInfo()
 {
   uint32_t tocOffset;
   uint16_t tocLength;
   parseHeader(&tocOffset, &tocLength);
   parseTableOfContents(tocOffset, tocLength);
   parseFonts();
-  parseColors();
-  parseXforms();
+
+  if (m_bigEndian)
+    parseDocumentRecords<PMDBigEndian>();
+  else
+    parseDocumentRecords<PMDLittleEndian>();
+
+  return getPageContainer().m_numRecords;
+}
+
+void PMDParser::reparseShapes(const uint16_t seqNum, const unsigned pageID)
+{
+  if (m_bigEndian)
+    parseShapes<PMDBigEndian>(m_input, seqNum, pageID);
+  else
+    parseShapes<PMDLittleEndian>(m_input, seqNum, pageID);
+}
+
+unsigned PMDParser::countRecordContainers(const uint16_t seqNum) const
+{
+  unsigned count = 0;
+  for (RecordIterator it = beginRecordsWithSeqNumber(seqNum); it != endRecords(); ++it)
+    ++count;
+  return count;
+}
+
+template<typename Endian>
+void PMDParser::parseDocumentRecords()
+{
+  parseColors<Endian>();
 
   auto i = m_records.find(GLOBAL_INFO);
   if (i != m_records.end()
       && !(i->second.empty()))
   {
-    parseGlobalInfo(m_recordsInOrder[i->second[0]]);
+    parseGlobalInfo<Endian>(m_recordsInOrder[i->second[0]]);
   }
   else
   {
     throw RecordNotFoundException(GLOBAL_INFO);
   }
+}
 
-  i = m_records.find(PAGE);
-  if (i != m_records.end()
-      && !(i->second.empty()))
-  {
-    parsePages(m_recordsInOrder[i->second[0]]);
-  }
-  else
-  {
+template<typename Endian>
+void PMDParser::parseRecords()
+{
+  parseDocumentRecords<Endian>();
+  parseXforms<Endian>();
+
+  parsePages<Endian>(getPageContainer());
+}
+
+const PMDRecordContainer &PMDParser::getPageContainer() const
+{
+  auto i = m_records.find(PAGE);
+  if (i == m_records.end() || i->second.empty())
     throw RecordNotFoundException(PAGE);
-  }
+  return m_recordsInOrder[i->second[0]];
 }
 
 PMDParser::RecordIterator PMDParser::beginRecordsWithSeqNumber(const uint16_t seqNum) const
 {
-  return RecordIterator(m_recordsInOrder, seqNum);
+  const RecordSeqNumMap_t::const_iterator it = m_recordsBySeqNum.find(seqNum);
+  if (it == m_recordsBySeqNum.end())
+    return endRecords();
+  return RecordIterator(m_recordsInOrder, it->second);
 }
 
 PMDParser::RecordIterator PMDParser::beginRecordsOfType(const uint16_t recType) const
 {
-  return RecordIterator(m_recordsInOrder, m_records, recType);
+  const RecordTypeMap_t::const_iterator it = m_records.find(recType);
+  if (it == m_records.end())
+    return endRecords();
+  return RecordIterator(m_recordsInOrder, it->second);
 }
 
 PMDParser::RecordIterator PMDParser::endRecords() const
@@ -11,50 +11,109 @@
 #define __PMDPARSER_H__
 
 #include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 #include <librevenge/librevenge.h>
 
+#include <libpagemaker/libpagemaker.h>
+
+#include "PMDByteReader.h"
 #include "PMDRecord.h"
+#include "PMDWorkCounter.h"
 #include "geometry.h"
 
 namespace libpagemaker
 {
 
 class PMDCollector;
+template<typename Endian> class PMDRecordView;
+
 class PMDParser
 {
   typedef std::vector<PMDRecordContainer> RecordContainerList_t;
-  typedef std::map<uint16_t, std::vector<unsigned> > RecordTypeMap_t;
+  typedef std::vector<unsigned> RecordIndexList_t;
+  typedef std::map<uint16_t, RecordIndexList_t> RecordTypeMap_t;
+  typedef std::unordered_map<unsigned, RecordIndexList_t> RecordSeqNumMap_t;
 
-  librevenge::RVNGInputStream *m_input;
+  /// The whole PageMaker stream. Bitmaps keep referring to it after parsing.
+  std::shared_ptr<const std::vector<unsigned char> > m_data;
+  /// Reads the stream on demand instead; only set if m_data is not.
+  std::unique_ptr<PMDByteSource> m_source;
+  PMDByteReader m_input;
   unsigned long m_length;
   PMDCollector *m_collector;
+  const PMDParseOptions m_options;
+  PMDLimits *const m_limits;
+  PMDWorkCounter m_work;
   RecordTypeMap_t m_records;
+  RecordSeqNumMap_t m_recordsBySeqNum;
   bool m_bigEndian;
   RecordContainerList_t m_recordsInOrder;
   std::map<uint32_t, PMDXForm> m_xFormMap;
 
+  /// The record seqNums of a text block's story.
+  struct TextBlock
+  {
+    uint16_t m_textSeqNum;
+    uint16_t m_charsSeqNum;
+    uint16_t m_paraSeqNum;
+  };
+  /// Read when the first text box is decoded; most pages and documents have none.
+  std::map<uint32_t, TextBlock> m_textBlocks;
+  std::once_flag m_textBlocksOnce;
+
+  /// Decoded stories, keyed by the seqNums of their text, chars and para records.
+  typedef std::tuple<uint16_t, uint16_t, uint16_t> StoryKey_t;
+  typedef std::map<StoryKey_t, std::shared_ptr<const PMDStory> > StoryMap_t;
+  StoryMap_t m_stories;
+  std::mutex m_storiesMutex;
+
+  /// Decoded bitmaps, keyed by the hash of their content.
+  typedef std::unordered_multimap<uint64_t, std::shared_ptr<const PMDBitmapSource> > BitmapMap_t;
+  BitmapMap_t m_bitmaps;
+  std::mutex m_bitmapsMutex;
+
+  /// A page whose shapes are to be decoded.
+  struct PageShapes
+  {
+    unsigned m_pageID;
+    uint16_t m_shapesSeqNum;
+  };
+
   struct ToCState;
   class RecordIterator;
 
   /* Private functions. */
-  void parseGlobalInfo(const PMDRecordContainer &container);
+  void seekToRecord(PMDByteReader &input, const PMDRecordContainer &container, unsigned recordIndex);
+  template<typename Endian> PMDRecordView<Endian> readRecord(PMDByteReader &input, const PMDRecordContainer &container, unsigned recordIndex, unsigned recordSize);
+  template<typename Endian> void parseGlobalInfo(const PMDRecordContainer &container);
   void parseFonts();
-  void parseColors();
-  void parsePages(const PMDRecordContainer &container);
-  void parseShapes(uint16_t seqNum, unsigned pageID);
-  void parseLine(const PMDRecordContainer &container, unsigned recordIndex, unsigned pageID);
-  void parseTextBox(const PMDRecordContainer &container, unsigned recordIndex, unsigned pageID);
-  void parseRectangle(const PMDRecordContainer &container, unsigned recordIndex, unsigned pageID);
-  void parsePolygon(const PMDRecordContainer &container, unsigned recordIndex, unsigned pageID);
-  void parseEllipse(const PMDRecordContainer &container, unsigned recordIndex, unsigned pageID);
-  void parseBitmap(const PMDRecordContainer &container, unsigned recordIndex, unsigned pageID);
+  template<typename Endian> void parseColors();
+  template<typename Endian> void parsePages(const PMDRecordContainer &container);
+  template<typename Endian> void parsePageShapes(const std::vector<PageShapes> &pages, unsigned threads);
+  bool isShapeWanted(uint8_t shapeType) const;
+  template<typename Endian> void parseShapes(PMDByteReader &input, uint16_t seqNum, unsigned pageID);
+  template<typename Endian> void parseLine(const PMDRecordView<Endian> &record, unsigned pageID);
+  template<typename Endian> void parseTextBox(PMDByteReader &input, const PMDRecordView<Endian> &record, unsigned pageID);
+  template<typename Endian> std::shared_ptr<const PMDStory> getStory(PMDByteReader &input, uint16_t textSeqNum, uint16_t charsSeqNum, uint16_t paraSeqNum);
+  template<typename Endian> void parseRectangle(const PMDRecordView<Endian> &record, unsigned pageID);
+  template<typename Endian> void parsePolygon(PMDByteReader &input, const PMDRecordView<Endian> &record, unsigned pageID);
+  template<typename Endian> void parseEllipse(const PMDRecordView<Endian> &record, unsigned pageID);
+  std::shared_ptr<const PMDBitmapSource> getUniqueBitmap(const std::shared_ptr<const PMDBitmapSource> &bitmap);
+  template<typename Endian> void parseBitmap(PMDByteReader &input, const PMDRecordView<Endian> &record, unsigned pageID);
   void parseHeader(uint32_t *tocOffset, uint16_t *tocLength);
+  template<typename Endian> void parseDocumentRecords();
+  template<typename Endian> void parseRecords();
+  const PMDRecordContainer &getPageContainer() const;
   void readNextRecordFromTableOfContents(ToCState &state, bool subRecord, uint16_t subRecordType = 0);
   void readTableOfContents(ToCState &state, uint32_t offset, unsigned records, bool subRecords, uint16_t subRecordType = 0);
   void parseTableOfContents(uint32_t offset, uint16_t length);
-  void parseXforms();
+  template<typename Endian> void parseXforms();
+  template<typename Endian> void parseTextBlocks(PMDByteReader &input);
   const PMDXForm &getXForm(const uint32_t xFormId) const;
 
   RecordIterator beginRecordsWithSeqNumber(uint16_t seqNum) const;
@@ -65,8 +124,21 @@ class PMDParser
   PMDParser &operator=(const PMDParser &);
   PMDParser(const PMDParser &);
 public:
+  /// The limits are not owned; without them, only the work budget of the options is enforced.
+  PMDParser(librevenge::RVNGInputStream *, PMDCollector *, const PMDParseOptions &, PMDLimits *limits = 0);
+  /**
+    Reads only the parts of the stream that are needed, instead of
+    loading all of it, so the cost does not depend on the size of the
+    document. Only parseInfo() can be used then.
+  */
   PMDParser(librevenge::RVNGInputStream *, PMDCollector *);
   void parse();
+  /// Reads the document-level records only. Returns the number of pages.
+  unsigned parseInfo();
+
+  /* Entry points for the micro-benchmarks in src/bench; valid after parse() */
+  void reparseShapes(uint16_t seqNum, unsigned pageID);
+  unsigned countRecordContainers(uint16_t seqNum) const;
 };
 
 }
@@ -0,0 +1,89 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDPROGRESSREPORTER_H__
+#define __PMDPROGRESSREPORTER_H__
+
+#include <mutex>
+
+#include <libpagemaker/libpagemaker.h>
+
+#include "PMDExceptions.h"
+
+namespace libpagemaker
+{
+
+/**
+ * Passes the progress of the parsing to a PMDProgress.
+ *
+ * It counts the pages and serializes the calls from the decoding
+ * threads. Once the receiver has cancelled, every further report
+ * throws CancelledException, so all threads stop after their current
+ * page.
+ */
+class PMDProgressReporter
+{
+  PMDProgress *const m_progress;
+  std::mutex m_mutex;
+  bool m_cancelled;
+  unsigned m_decodedPages;
+  unsigned m_pagesToDecode;
+  unsigned m_paintedPages;
+  unsigned m_pagesToPaint;
+
+  void check(const bool proceed)
+  {
+    if (!proceed)
+      m_cancelled = true;
+    if (m_cancelled)
+      throw CancelledException();
+  }
+
+  /* Prevent copy and assignment */
+  PMDProgressReporter &operator=(const PMDProgressReporter &);
+  PMDProgressReporter(const PMDProgressReporter &);
+
+public:
+  /// The receiver is not owned.
+  explicit PMDProgressReporter(PMDProgress *const progress)
+    : m_progress(progress), m_mutex(), m_cancelled(false),
+      m_decodedPages(0), m_pagesToDecode(0), m_paintedPages(0), m_pagesToPaint(0)
+  { }
+
+  void setPageCounts(const unsigned pagesToDecode, const unsigned pagesToPaint)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pagesToDecode = pagesToDecode;
+    m_pagesToPaint = pagesToPaint;
+  }
+
+  void tableOfContentsRead()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    check(m_cancelled || m_progress->tableOfContentsRead());
+  }
+
+  void pageDecoded()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    check(m_cancelled || m_progress->pageDecoded(++m_decodedPages, m_pagesToDecode));
+  }
+
+  void pagePainted()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    check(m_cancelled || m_progress->pagePainted(++m_paintedPages, m_pagesToPaint));
+  }
+};
+
+}
+
+#endif /* __PMDPROGRESSREPORTER_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
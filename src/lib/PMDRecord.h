@@ -22,6 +22,19 @@
 namespace libpagemaker
 {
 
+/* Sizes of fixed-size records */
+const unsigned SHAPE_RECORD_SIZE = 258;
+const unsigned GLOBAL_INFO_RECORD_SIZE = 2496;
+const unsigned PAGE_RECORD_SIZE = 472;
+const unsigned LINE_SET_RECORD_SIZE = 4;
+const unsigned XFORM_RECORD_SIZE = 26;
+const unsigned TEXT_BLOCK_RECORD_SIZE = 36;
+const unsigned CHARS_RECORD_SIZE = 30;
+const unsigned PARA_RECORD_SIZE = 80;
+const unsigned FONTS_RECORD_SIZE = 94;
+const unsigned FONTS_PARENT_RECORD_SIZE = 10;
+const unsigned COLORS_RECORD_SIZE = 210;
+
 struct PMDRecordContainer
 {
   uint16_t m_recordType;
@@ -40,27 +53,27 @@ inline boost::optional<unsigned> getRecordSize(uint16_t recType)
   switch (recType)
   {
   case SHAPE:
-    return 258;
+    return SHAPE_RECORD_SIZE;
   case GLOBAL_INFO:
-    return 2496;
+    return GLOBAL_INFO_RECORD_SIZE;
   case PAGE:
-    return 472;
+    return PAGE_RECORD_SIZE;
   case LINE_SET:
-    return 4;
+    return LINE_SET_RECORD_SIZE;
   case XFORM:
-    return 26;
+    return XFORM_RECORD_SIZE;
   case TEXT_BLOCK:
-    return 36;
+    return TEXT_BLOCK_RECORD_SIZE;
   case CHARS:
-    return 30;
+    return CHARS_RECORD_SIZE;
   case PARA:
-    return 80;
+    return PARA_RECORD_SIZE;
   case FONTS:
-    return 94;
+    return FONTS_RECORD_SIZE;
   case FONTS_PARENT:
-    return 10;
+    return FONTS_PARENT_RECORD_SIZE;
   case COLORS:
-    return 210;
+    return COLORS_RECORD_SIZE;
   default:
     return boost::none;
   }
@@ -0,0 +1,336 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDRECORDLAYOUT_H__
+#define __PMDRECORDLAYOUT_H__
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/optional.hpp>
+
+#include "PMDRecord.h"
+#include "PMDTypes.h"
+#include "Units.h"
+#include "geometry.h"
+#include "libpagemaker_utils.h"
+
+namespace libpagemaker
+{
+
+/**
+ * Byte order of a document: Windows files are little-endian, Mac files
+ * big-endian.
+ *
+ * The record decoders are instantiated for both, so the byte order is
+ * decided once per document instead of once per field. Compilers turn
+ * the shift-or sequences below into plain loads, resp. load + bswap.
+ */
+struct PMDLittleEndian
+{
+  static const bool IS_BIG = false;
+
+  static uint16_t readU16(const unsigned char *const p)
+  {
+    return static_cast<uint16_t>((uint16_t)p[0]|((uint16_t)p[1]<<8));
+  }
+
+  static uint32_t readU32(const unsigned char *const p)
+  {
+    return (uint32_t)p[0]|((uint32_t)p[1]<<8)|((uint32_t)p[2]<<16)|((uint32_t)p[3]<<24);
+  }
+};
+
+struct PMDBigEndian
+{
+  static const bool IS_BIG = true;
+
+  static uint16_t readU16(const unsigned char *const p)
+  {
+    return static_cast<uint16_t>((uint16_t)p[1]|((uint16_t)p[0]<<8));
+  }
+
+  static uint32_t readU32(const unsigned char *const p)
+  {
+    return (uint32_t)p[3]|((uint32_t)p[2]<<8)|((uint32_t)p[1]<<16)|((uint32_t)p[0]<<24);
+  }
+};
+
+/**
+ * Decoding of a single field value of type T from raw record bytes.
+ *
+ * SIZE is the number of bytes the field occupies in the record.
+ */
+template<typename T> struct PMDFieldTraits;
+
+template<> struct PMDFieldTraits<uint8_t>
+{
+  static const unsigned SIZE = 1;
+
+  template<typename Endian> static uint8_t read(const unsigned char *const p)
+  {
+    return p[0];
+  }
+};
+
+template<> struct PMDFieldTraits<uint16_t>
+{
+  static const unsigned SIZE = 2;
+
+  template<typename Endian> static uint16_t read(const unsigned char *const p)
+  {
+    return Endian::readU16(p);
+  }
+};
+
+template<> struct PMDFieldTraits<int16_t>
+{
+  static const unsigned SIZE = 2;
+
+  template<typename Endian> static int16_t read(const unsigned char *const p)
+  {
+    return static_cast<int16_t>(Endian::readU16(p));
+  }
+};
+
+template<> struct PMDFieldTraits<uint32_t>
+{
+  static const unsigned SIZE = 4;
+
+  template<typename Endian> static uint32_t read(const unsigned char *const p)
+  {
+    return Endian::readU32(p);
+  }
+};
+
+/// Big-endian files store the coordinates in reverse order.
+template<> struct PMDFieldTraits<PMDShapePoint>
+{
+  static const unsigned SIZE = 4;
+
+  template<typename Endian> static PMDShapePoint read(const unsigned char *const p)
+  {
+    const PMDShapeUnit first(static_cast<int16_t>(Endian::readU16(p)));
+    const PMDShapeUnit second(static_cast<int16_t>(Endian::readU16(p + 2)));
+    return Endian::IS_BIG ? PMDShapePoint(second, first) : PMDShapePoint(first, second);
+  }
+};
+
+/**
+ * Decodes a run of count consecutive points, as stored in LINE_SET
+ * records, and appends them to points.
+ *
+ * The loop body is free of branches and bounds checks (the caller has
+ * checked the whole run), so compilers can vectorize the byte swap and
+ * the coordinate shuffle.
+ */
+template<typename Endian>
+void readPoints(const unsigned char *const data, const std::size_t count, std::vector<PMDShapePoint> &points)
+{
+  const std::size_t first = points.size();
+  points.resize(first + count, PMDShapePoint(0, 0));
+  PMDShapePoint *const out = points.data() + first;
+  for (std::size_t i = 0; i != count; ++i)
+    out[i] = PMDFieldTraits<PMDShapePoint>::template read<Endian>(data + 4 * i);
+}
+
+/// Paragraph rule: flags (2), type (1), pad (1), width (4), color (2), tint (2), pad (6).
+template<> struct PMDFieldTraits<boost::optional<PMDStrokeProperties> >
+{
+  static const unsigned SIZE = 18;
+
+  template<typename Endian> static boost::optional<PMDStrokeProperties> read(const unsigned char *const p)
+  {
+    const uint16_t flags = Endian::readU16(p);
+    if (!(flags & 0x1))
+      return boost::none;
+
+    PMDStrokeProperties stroke;
+    stroke.m_strokeType = p[2];
+    // FIXME: needs fixing of reading of stroke width elsewhere
+    stroke.m_strokeWidth = uint16_t(Endian::readU32(p + 4) >> 8);
+    stroke.m_strokeColor = Endian::readU16(p + 8);
+    stroke.m_strokeTint = Endian::readU16(p + 10);
+    return stroke;
+  }
+};
+
+/// Position of a field of type T, relative to the start of its record.
+template<typename T> struct PMDField
+{
+  unsigned m_offset;
+};
+
+/**
+ * A single fixed-size record, read from the document in one block.
+ *
+ * Every field descriptor is checked against the record size at compile
+ * time. The last record of a stream may be cut short, though, so the
+ * view only covers the bytes that are available and reading a field
+ * past them throws EndOfStreamException, just as reading it from the
+ * stream would.
+ */
+template<typename Endian> class PMDRecordView
+{
+  const unsigned char *m_data;
+  std::size_t m_size;
+
+public:
+  PMDRecordView(const unsigned char *const data, const std::size_t size)
+    : m_data(data), m_size(size)
+  { }
+
+  template<typename T> T get(const PMDField<T> field) const
+  {
+    if (field.m_offset + PMDFieldTraits<T>::SIZE > m_size)
+      throw EndOfStreamException();
+    return PMDFieldTraits<T>::template read<Endian>(m_data + field.m_offset);
+  }
+};
+
+#define PMD_RECORD_FIELD(recordSize, name, type, offset) \
+  constexpr PMDField<type> name = { offset }; \
+  static_assert((offset) + PMDFieldTraits<type>::SIZE <= (recordSize), #name " does not fit into the record")
+
+namespace GlobalInfoRecord
+{
+PMD_RECORD_FIELD(GLOBAL_INFO_RECORD_SIZE, OPTIONS, uint8_t, 0x00);
+// FIXME: these are the bounds of both pages of a spread
+PMD_RECORD_FIELD(GLOBAL_INFO_RECORD_SIZE, PAGE_TOP_LEFT, PMDShapePoint, 0x36);
+PMD_RECORD_FIELD(GLOBAL_INFO_RECORD_SIZE, PAGE_BOT_RIGHT, PMDShapePoint, 0x3a);
+}
+
+namespace PageRecord
+{
+PMD_RECORD_FIELD(PAGE_RECORD_SIZE, SHAPES_SEQ_NUM, uint16_t, 0x02);
+PMD_RECORD_FIELD(PAGE_RECORD_SIZE, WIDTH, uint16_t, 0x08);
+}
+
+/// Fields common to all shapes.
+namespace ShapeRecord
+{
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, TYPE, uint8_t, 0x00);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, BBOX_TOP_LEFT, PMDShapePoint, 0x06);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, BBOX_BOT_RIGHT, PMDShapePoint, 0x0a);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, XFORM_ID, uint32_t, 0x1c);
+}
+
+namespace LineShape
+{
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, STROKE_COLOR, uint8_t, 0x04);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, MIRRORED, uint16_t, 0x26);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, STROKE_TYPE, uint8_t, 0x2e);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, STROKE_WIDTH, uint16_t, 0x30);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, STROKE_TINT, uint8_t, 0x33);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, STROKE_OVERPRINT, uint8_t, 0x3a);
+}
+
+/// Rectangles, ellipses and polygons.
+namespace FilledShape
+{
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, FILL_OVERPRINT, uint8_t, 0x02);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, FILL_COLOR, uint8_t, 0x04);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, STROKE_TYPE, uint8_t, 0x20);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, STROKE_WIDTH, uint16_t, 0x23);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, FILL_TYPE, uint8_t, 0x26);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, STROKE_COLOR, uint8_t, 0x28);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, STROKE_OVERPRINT, uint8_t, 0x2a);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, STROKE_TINT, uint8_t, 0x2c);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, FILL_TINT, uint8_t, 0xe0);
+}
+
+namespace PolygonShape
+{
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, LINE_SET_SEQ_NUM, uint16_t, 0x2e);
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, CLOSED_MARKER, uint8_t, 0x38);
+}
+
+namespace TextBoxShape
+{
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, TEXT_BLOCK_ID, uint32_t, 0x20);
+}
+
+namespace BitmapShape
+{
+PMD_RECORD_FIELD(SHAPE_RECORD_SIZE, TIFF_SEQ_NUM, uint16_t, 0x30);
+}
+
+static_assert(LINE_SET_RECORD_SIZE == PMDFieldTraits<PMDShapePoint>::SIZE, "a LINE_SET record is a single point");
+
+namespace XFormRecord
+{
+PMD_RECORD_FIELD(XFORM_RECORD_SIZE, ROTATION, uint32_t, 0x00);
+PMD_RECORD_FIELD(XFORM_RECORD_SIZE, SKEW, uint32_t, 0x04);
+PMD_RECORD_FIELD(XFORM_RECORD_SIZE, TOP_LEFT, PMDShapePoint, 0x0a);
+PMD_RECORD_FIELD(XFORM_RECORD_SIZE, BOT_RIGHT, PMDShapePoint, 0x0e);
+PMD_RECORD_FIELD(XFORM_RECORD_SIZE, ROTATING_POINT, PMDShapePoint, 0x12);
+PMD_RECORD_FIELD(XFORM_RECORD_SIZE, ID, uint32_t, 0x16);
+}
+
+namespace TextBlockRecord
+{
+PMD_RECORD_FIELD(TEXT_BLOCK_RECORD_SIZE, PROPS_ONE, uint16_t, 0x00);
+PMD_RECORD_FIELD(TEXT_BLOCK_RECORD_SIZE, PROPS_TWO, uint16_t, 0x02);
+PMD_RECORD_FIELD(TEXT_BLOCK_RECORD_SIZE, TEXT_SEQ_NUM, uint16_t, 0x04);
+PMD_RECORD_FIELD(TEXT_BLOCK_RECORD_SIZE, CHARS_SEQ_NUM, uint16_t, 0x06);
+PMD_RECORD_FIELD(TEXT_BLOCK_RECORD_SIZE, PARA_SEQ_NUM, uint16_t, 0x08);
+PMD_RECORD_FIELD(TEXT_BLOCK_RECORD_SIZE, STYLE, uint16_t, 0x0a);
+PMD_RECORD_FIELD(TEXT_BLOCK_RECORD_SIZE, ID, uint32_t, 0x20);
+}
+
+namespace CharsRecord
+{
+PMD_RECORD_FIELD(CHARS_RECORD_SIZE, LENGTH, uint16_t, 0x00);
+PMD_RECORD_FIELD(CHARS_RECORD_SIZE, FONT_FACE, uint16_t, 0x02);
+PMD_RECORD_FIELD(CHARS_RECORD_SIZE, FONT_SIZE, uint16_t, 0x04);
+PMD_RECORD_FIELD(CHARS_RECORD_SIZE, FONT_COLOR, uint16_t, 0x08);
+PMD_RECORD_FIELD(CHARS_RECORD_SIZE, FLAGS, uint16_t, 0x0a);
+PMD_RECORD_FIELD(CHARS_RECORD_SIZE, KERNING, int16_t, 0x10);
+PMD_RECORD_FIELD(CHARS_RECORD_SIZE, SUPER_SUB_SIZE, uint16_t, 0x14);
+PMD_RECORD_FIELD(CHARS_RECORD_SIZE, SUB_POS, uint16_t, 0x16);
+PMD_RECORD_FIELD(CHARS_RECORD_SIZE, SUPER_POS, uint16_t, 0x18);
+PMD_RECORD_FIELD(CHARS_RECORD_SIZE, TINT, uint16_t, 0x1c);
+}
+
+namespace ParaRecord
+{
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, LENGTH, uint16_t, 0x00);
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, FLAGS, uint8_t, 0x02);
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, ALIGN, uint8_t, 0x03);
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, LEFT_INDENT, uint16_t, 0x0a);
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, FIRST_INDENT, uint16_t, 0x0c);
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, RIGHT_INDENT, uint16_t, 0x0e);
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, BEFORE_INDENT, uint16_t, 0x10);
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, AFTER_INDENT, uint16_t, 0x12);
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, HYPHENS_COUNT, uint8_t, 0x26);
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, KEEP_OPTIONS, uint16_t, 0x28);
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, RULE_ABOVE, boost::optional<PMDStrokeProperties>, 0x2c);
+PMD_RECORD_FIELD(PARA_RECORD_SIZE, RULE_BELOW, boost::optional<PMDStrokeProperties>, 0x3e);
+}
+
+namespace ColorRecord
+{
+PMD_RECORD_FIELD(COLORS_RECORD_SIZE, MODEL, uint8_t, 0x22);
+PMD_RECORD_FIELD(COLORS_RECORD_SIZE, RED, uint8_t, 0x26);
+PMD_RECORD_FIELD(COLORS_RECORD_SIZE, GREEN, uint8_t, 0x27);
+PMD_RECORD_FIELD(COLORS_RECORD_SIZE, BLUE, uint8_t, 0x28);
+PMD_RECORD_FIELD(COLORS_RECORD_SIZE, CYAN, uint16_t, 0x26);
+PMD_RECORD_FIELD(COLORS_RECORD_SIZE, MAGENTA, uint16_t, 0x28);
+PMD_RECORD_FIELD(COLORS_RECORD_SIZE, YELLOW, uint16_t, 0x2a);
+PMD_RECORD_FIELD(COLORS_RECORD_SIZE, BLACK, uint16_t, 0x2c);
+}
+
+#undef PMD_RECORD_FIELD
+
+}
+
+#endif /* __PMDRECORDLAYOUT_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,93 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDSTATS_H__
+#define __PMDSTATS_H__
+
+#include <atomic>
+#include <chrono>
+
+#include <libpagemaker/libpagemaker.h>
+
+namespace libpagemaker
+{
+
+/**
+ * Accumulates the time spent in the phases of parsing and output.
+ *
+ * Shapes may be decoded on several threads, so the counters are atomic.
+ */
+class PMDStats
+{
+  std::atomic<unsigned long> m_counts[PMD_PHASE_COUNT];
+  std::atomic<long long> m_nanoseconds[PMD_PHASE_COUNT];
+
+  /* Prevent copy and assignment */
+  PMDStats &operator=(const PMDStats &);
+  PMDStats(const PMDStats &);
+
+public:
+  PMDStats()
+    : m_counts(), m_nanoseconds()
+  { }
+
+  void add(const PMDStatsPhase phase, const std::chrono::steady_clock::duration time)
+  {
+    ++m_counts[phase];
+    m_nanoseconds[phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+  }
+
+  void get(PMDParseStats &stats) const
+  {
+    stats.m_available = true;
+    for (unsigned i = 0; i != PMD_PHASE_COUNT; ++i)
+    {
+      stats.m_phases[i].m_count = m_counts[i];
+      stats.m_phases[i].m_seconds = m_nanoseconds[i] / 1e9;
+    }
+  }
+};
+
+/**
+ * Adds the time until the end of its scope to a phase. Does nothing if
+ * no stats are being collected.
+ */
+class PMDPhaseTimer
+{
+  PMDStats *const m_stats;
+  const PMDStatsPhase m_phase;
+  const std::chrono::steady_clock::time_point m_start;
+
+  /* Prevent copy and assignment */
+  PMDPhaseTimer &operator=(const PMDPhaseTimer &);
+  PMDPhaseTimer(const PMDPhaseTimer &);
+
+public:
+  PMDPhaseTimer(PMDStats *const stats, const PMDStatsPhase phase)
+    : m_stats(stats), m_phase(phase), m_start(stats ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point())
+  { }
+
+  ~PMDPhaseTimer()
+  {
+    if (m_stats)
+      m_stats->add(m_phase, std::chrono::steady_clock::now() - m_start);
+  }
+};
+
+}
+
+#ifdef PMD_ENABLE_STATS
+#define PMD_TIME_PHASE(stats, phase) const libpagemaker::PMDPhaseTimer pmdPhaseTimer(stats, phase)
+#else
+#define PMD_TIME_PHASE(stats, phase)
+#endif
+
+#endif /* __PMDSTATS_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -0,0 +1,43 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "PMDStreamByteSource.h"
+
+#include <algorithm>
+
+#include "libpagemaker_utils.h"
+
+namespace libpagemaker
+{
+
+PMDStreamByteSource::PMDStreamByteSource(librevenge::RVNGInputStream *const input)
+  : PMDByteSource(), m_input(input), m_block()
+{
+}
+
+const unsigned char *PMDStreamByteSource::load(const unsigned long offset, const unsigned long numBytes, unsigned long &length)
+{
+  const unsigned long wanted = (std::max)(numBytes, BLOCK_SIZE);
+  m_block.clear();
+  seek(m_input, offset);
+  while (m_block.size() < wanted && !m_input->isEnd())
+  {
+    unsigned long numBytesRead = 0;
+    const unsigned char *const p = m_input->read(wanted - m_block.size(), numBytesRead);
+    if (!p || numBytesRead == 0)
+      break;
+    m_block.insert(m_block.end(), p, p + numBytesRead);
+  }
+  length = m_block.size();
+  return m_block.data();
+}
+
+}
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
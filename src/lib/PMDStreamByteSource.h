@@ -0,0 +1,49 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDSTREAMBYTESOURCE_H__
+#define __PMDSTREAMBYTESOURCE_H__
+
+#include <vector>
+
+#include <librevenge-stream/librevenge-stream.h>
+
+#include "PMDByteReader.h"
+
+namespace libpagemaker
+{
+
+/**
+ * Byte source that reads blocks of an input stream on demand, so only
+ * the parts of the stream that are actually read are held in memory.
+ */
+class PMDStreamByteSource : public PMDByteSource
+{
+  librevenge::RVNGInputStream *m_input;
+  std::vector<unsigned char> m_block;
+
+  /* Prevent copy and assignment */
+  PMDStreamByteSource &operator=(const PMDStreamByteSource &);
+  PMDStreamByteSource(const PMDStreamByteSource &);
+
+public:
+  /// Minimal number of bytes read at once.
+  static const unsigned long BLOCK_SIZE = 4096;
+
+  /// Reads from input, which is not owned.
+  explicit PMDStreamByteSource(librevenge::RVNGInputStream *input);
+
+  const unsigned char *load(unsigned long offset, unsigned long numBytes, unsigned long &length) override;
+};
+
+}
+
+#endif /* __PMDSTREAMBYTESOURCE_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -9,6 +9,8 @@
 
 #include "PMDTypes.h"
 
+#include <algorithm>
+
 #include "constants.h"
 
 namespace libpagemaker
@@ -73,6 +75,95 @@ PMDCharProperties::PMDCharProperties()
 {
 }
 
+PMDStory::PMDStory()
+  : m_text()
+  , m_charProps()
+  , m_paraProps()
+{
+}
+
+PMDBitmapSource::PMDBitmapSource(const std::shared_ptr<const std::vector<unsigned char> > &document)
+  : m_document(document)
+  , m_chunks()
+{
+}
+
+bool PMDBitmapSource::empty() const
+{
+  for (const auto &chunk : m_chunks)
+  {
+    if (chunk.second != 0)
+      return false;
+  }
+  return true;
+}
+
+unsigned long PMDBitmapSource::size() const
+{
+  unsigned long size = 0;
+  for (const auto &chunk : m_chunks)
+    size += chunk.second;
+  return size;
+}
+
+librevenge::RVNGBinaryData PMDBitmapSource::read() const
+{
+  librevenge::RVNGBinaryData data;
+  for (const auto &chunk : m_chunks)
+    data.append(m_document->data() + chunk.first, chunk.second);
+  return data;
+}
+
+uint64_t PMDBitmapSource::hash() const
+{
+  // 64-bit FNV-1a
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const auto &chunk : m_chunks)
+  {
+    const unsigned char *const data = m_document->data() + chunk.first;
+    for (unsigned long i = 0; i != chunk.second; ++i)
+    {
+      hash ^= data[i];
+      hash *= 0x100000001b3ull;
+    }
+  }
+  return hash;
+}
+
+bool PMDBitmapSource::hasSameContent(const PMDBitmapSource &other) const
+{
+  if (m_document == other.m_document && m_chunks == other.m_chunks)
+    return true;
+
+  // The two may be split into chunks differently.
+  auto it = m_chunks.begin();
+  auto otherIt = other.m_chunks.begin();
+  unsigned long pos = 0;
+  unsigned long otherPos = 0;
+  while (true)
+  {
+    while (it != m_chunks.end() && pos == it->second)
+    {
+      ++it;
+      pos = 0;
+    }
+    while (otherIt != other.m_chunks.end() && otherPos == otherIt->second)
+    {
+      ++otherIt;
+      otherPos = 0;
+    }
+    if (it == m_chunks.end() || otherIt == other.m_chunks.end())
+      return it == m_chunks.end() && otherIt == other.m_chunks.end();
+
+    const unsigned long length = (std::min)(it->second - pos, otherIt->second - otherPos);
+    if (!std::equal(m_document->data() + it->first + pos, m_document->data() + it->first + pos + length,
+                    other.m_document->data() + otherIt->first + otherPos))
+      return false;
+    pos += length;
+    otherPos += length;
+  }
+}
+
 }
 
 /* vim:set shiftwidth=2 softtabstop=2 expandtab: */
@@ -10,7 +10,10 @@
 #ifndef __PMDTYPES_H__
 #define __PMDTYPES_H__
 
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <boost/optional.hpp>
 
@@ -109,6 +112,41 @@ struct PMDCharProperties
   PMDCharProperties();
 };
 
+/** A text together with its character and paragraph formatting. */
+struct PMDStory
+{
+  std::string m_text;
+  std::vector<PMDCharProperties> m_charProps;
+  std::vector<PMDParaProperties> m_paraProps;
+
+  PMDStory();
+};
+
+/**
+ * The location of a bitmap's bytes in the document.
+ *
+ * The bytes are only copied out of the document, by read(), when the
+ * bitmap is painted.
+ */
+struct PMDBitmapSource
+{
+  std::shared_ptr<const std::vector<unsigned char> > m_document;
+  /// Offsets and lengths of the bitmap's parts in the document.
+  std::vector<std::pair<unsigned long, unsigned long> > m_chunks;
+
+  explicit PMDBitmapSource(const std::shared_ptr<const std::vector<unsigned char> > &document);
+
+  bool empty() const;
+  /// Number of bytes of the bitmap.
+  unsigned long size() const;
+  librevenge::RVNGBinaryData read() const;
+
+  /// Hash of the bitmap's bytes.
+  uint64_t hash() const;
+  /// Whether both bitmaps consist of the same bytes.
+  bool hasSameContent(const PMDBitmapSource &other) const;
+};
+
 }
 
 #endif // __PMDTYPES_H__
@@ -0,0 +1,106 @@
+/* -*- Mode: C++; tab-width: 2; indent-tabs-mode: nil; c-basic-offset: 2 -*- */
+/*
+ * This file is part of the libpagemaker project.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef __PMDWORKCOUNTER_H__
+#define __PMDWORKCOUNTER_H__
+
+#include <atomic>
+
+#include <libpagemaker/libpagemaker.h>
+
+#include "PMDByteReader.h"
+#include "PMDExceptions.h"
+#include "PMDLimits.h"
+
+namespace libpagemaker
+{
+
+/**
+ * Counts the work done by the parser and enforces the work budget.
+ *
+ * The readers count their bytes and seeks themselves; they are
+ * collected whenever a record is visited. The counts are copied to the
+ * caller's PMDWorkStats on destruction, so they are available even if
+ * parsing has failed. It is safe to count from several threads.
+ *
+ * If limits are given, the records visited are checked against them.
+ * If neither the stats, nor the budget, nor any record limit is set,
+ * nothing is counted, so the shared counters cost nothing in normal
+ * parsing.
+ */
+class PMDWorkCounter
+{
+  std::atomic<unsigned long> m_records;
+  std::atomic<unsigned long> m_bytesRead;
+  std::atomic<unsigned long> m_seeks;
+  std::atomic<bool> m_exceeded;
+  const unsigned long m_budget;
+  PMDWorkStats *const m_stats;
+  const PMDLimits *const m_limits;
+  const bool m_enabled;
+
+  /* Prevent copy and assignment */
+  PMDWorkCounter &operator=(const PMDWorkCounter &);
+  PMDWorkCounter(const PMDWorkCounter &);
+
+public:
+  PMDWorkCounter(const unsigned long budget, PMDWorkStats *const stats, const PMDLimits *const limits)
+    : m_records(0), m_bytesRead(0), m_seeks(0), m_exceeded(false), m_budget(budget), m_stats(stats), m_limits(limits),
+      m_enabled(budget != 0 || stats || (limits && limits->limitsRecords()))
+  { }
+
+  ~PMDWorkCounter()
+  {
+    if (!m_stats)
+      return;
+    m_stats->m_records = m_records;
+    m_stats->m_bytesRead = m_bytesRead;
+    m_stats->m_seeks = m_seeks;
+    m_stats->m_exceeded = m_exceeded;
+  }
+
+  /// Counts a visited record. Throws a LimitExceededException if the budget or a limit is used up.
+  void visitRecord(PMDByteReader &input)
+  {
+    if (m_enabled)
+      add(1, input);
+  }
+
+  /// Collects the reads of input that have not been counted yet.
+  void collect(PMDByteReader &input)
+  {
+    if (m_enabled)
+      add(0, input);
+  }
+
+private:
+  void add(const unsigned long records, PMDByteReader &input)
+  {
+    unsigned long bytesRead = 0;
+    unsigned long seeks = 0;
+    input.takeCounts(bytesRead, seeks);
+    const unsigned long totalRecords = m_records.fetch_add(records, std::memory_order_relaxed) + records;
+    const unsigned long work = totalRecords
+                               + (m_bytesRead.fetch_add(bytesRead, std::memory_order_relaxed) + bytesRead)
+                               + (m_seeks.fetch_add(seeks, std::memory_order_relaxed) + seeks);
+    if (m_budget != 0 && work > m_budget)
+    {
+      m_exceeded = true;
+      throw WorkBudgetExceededException();
+    }
+    if (m_limits && records != 0)
+      m_limits->checkRecords(totalRecords);
+  }
+};
+
+}
+
+#endif /* __PMDWORKCOUNTER_H__ */
+
+/* vim:set shiftwidth=2 softtabstop=2 expandtab: */
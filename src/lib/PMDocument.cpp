@@ -11,13 +11,35 @@
 
 #include <libpagemaker/libpagemaker.h>
 
+#include "PMDAllocationScope.h"
 #include "PMDCollector.h"
+#include "PMDCountingInputStream.h"
+#include "PMDExceptions.h"
+#include "PMDLimitedPainter.h"
+#include "PMDLimits.h"
 #include "PMDParser.h"
 #include "libpagemaker_utils.h"
 
 namespace libpagemaker
 {
 
+namespace
+{
+
+void setStreamPhase(PMDCountingInputStream *const stream, const PMDStreamPhase phase)
+{
+  if (stream)
+    stream->setPhase(phase);
+}
+
+void setError(const PMDParseOptions &options, const PMDParseError error)
+{
+  if (options.m_error)
+    *options.m_error = error;
+}
+
+}
+
 bool PMDocument::isSupported(librevenge::RVNGInputStream *input) try
 {
   return input && input->isStructured() && input->existsSubStream("PageMaker");
@@ -27,20 +49,93 @@ catch (...)
   return false;
 }
 
-bool PMDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter) try
+bool PMDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter)
 {
+  return parse(input, painter, PMDParseOptions());
+}
+
+bool PMDocument::parse(librevenge::RVNGInputStream *input, librevenge::RVNGDrawingInterface *painter, const PMDParseOptions &options) try
+{
+  setError(options, PMD_ERROR_UNSUPPORTED);
   if (!input || !painter)
     return false;
 
+  PMDLimits limits(options);
+  std::unique_ptr<PMDLimitedPainter> limitedPainter;
+  if (limits.limitsPainter())
+  {
+    limitedPainter.reset(new PMDLimitedPainter(painter, limits));
+    painter = limitedPainter.get();
+  }
+
+  // Output sets its own scopes.
+  const PMDAllocationScope allocationScope(PMD_ALLOCATION_PHASE_PARSE, PMD_ALLOCATION_SHAPE_NONE);
+
+  std::unique_ptr<PMDCountingInputStream> countingInput;
+  if (options.m_streamStats)
+  {
+    countingInput.reset(new PMDCountingInputStream(input, *options.m_streamStats));
+    input = countingInput.get();
+  }
+
   if (!isSupported(input))
     return false;
+  setError(options, PMD_ERROR_PARSE);
 
   PMDCollector collector;
   PMD_DEBUG_MSG(("About to start parsing...\n"));
+  setStreamPhase(countingInput.get(), PMD_STREAM_PHASE_OPEN);
+  std::unique_ptr<librevenge::RVNGInputStream> pmdStream(input->getSubStreamByName("PageMaker"));
+  setStreamPhase(countingInput.get(), PMD_STREAM_PHASE_LOAD);
+  PMDParser parser(pmdStream.get(), &collector, options, &limits);
+  limits.checkTime();
+  setStreamPhase(countingInput.get(), PMD_STREAM_PHASE_PARSE);
+  if (options.m_streaming)
+  {
+    collector.startStreaming(painter);
+    parser.parse();
+    collector.endStreaming();
+  }
+  else
+  {
+    parser.parse();
+    limits.checkTime();
+    PMD_DEBUG_MSG(("About to start drawing...\n"));
+    collector.draw(painter);
+  }
+#ifdef PMD_ENABLE_STATS
+  if (options.m_stats)
+    collector.getStats()->get(*options.m_stats);
+#endif
+  setError(options, PMD_ERROR_NONE);
+  return true;
+}
+catch (const LimitExceededException &e)
+{
+  setError(options, e.m_error);
+  return false;
+}
+catch (const CancelledException &)
+{
+  setError(options, PMD_ERROR_CANCELLED);
+  return false;
+}
+catch (...)
+{
+  return false;
+}
+
+bool PMDocument::parseInfo(librevenge::RVNGInputStream *input, PMDDocumentInfo &info) try
+{
+  if (!isSupported(input))
+    return false;
+
+  PMDCollector collector;
   std::unique_ptr<librevenge::RVNGInputStream> pmdStream(input->getSubStreamByName("PageMaker"));
-  PMDParser(pmdStream.get(), &collector).parse();
-  PMD_DEBUG_MSG(("About to start drawing...\n"));
-  collector.draw(painter);
+  const unsigned pageCount = PMDParser(pmdStream.get(), &collector).parseInfo();
+  info = PMDDocumentInfo();
+  collector.fillInfo(info);
+  info.m_pageCount = pageCount;
   return true;
 }
 catch (...)
@@ -10,6 +10,7 @@
 #ifndef __LIBPAGEMAKER_GEOMETRY_H__
 #define __LIBPAGEMAKER_GEOMETRY_H__
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -64,10 +65,8 @@ public:
   virtual PMDShapePoint getBboxBotRight() const = 0;
   virtual PMDFillProperties getFillProperties() const = 0;
   virtual PMDStrokeProperties getStrokeProperties() const = 0;
-  virtual std::string getText() const = 0;
-  virtual std::vector<PMDCharProperties> getCharProperties() const = 0;
-  virtual std::vector<PMDParaProperties> getParaProperties() const = 0;
-  virtual librevenge::RVNGBinaryData getBitmap() const = 0;
+  virtual std::shared_ptr<const PMDStory> getStory() const = 0;
+  virtual std::shared_ptr<const PMDBitmapSource> getBitmap() const = 0;
 
 
   virtual ~PMDLineSet()
@@ -161,25 +160,14 @@ public:
     return m_strokeProps;
   }
 
-  std::string getText() const override
+  std::shared_ptr<const PMDStory> getStory() const override
   {
-    return "";
+    return std::shared_ptr<const PMDStory>();
   }
 
-  std::vector<PMDCharProperties> getCharProperties() const override
+  std::shared_ptr<const PMDBitmapSource> getBitmap() const override
   {
-    return std::vector<PMDCharProperties>(1);
-  }
-
-  std::vector<PMDParaProperties> getParaProperties() const override
-  {
-    return std::vector<PMDParaProperties>(1);
-  }
-
-  librevenge::RVNGBinaryData getBitmap() const override
-  {
-    librevenge::RVNGBinaryData temp;
-    return temp;
+    return std::shared_ptr<const PMDBitmapSource>();
   }
 
   ~PMDLine() override
@@ -265,25 +253,14 @@ public:
     return m_strokeProps;
   }
 
-  std::string getText() const override
-  {
-    return "";
-  }
-
-  std::vector<PMDCharProperties> getCharProperties() const override
+  std::shared_ptr<const PMDStory> getStory() const override
   {
-    return std::vector<PMDCharProperties>(1);
+    return std::shared_ptr<const PMDStory>();
   }
 
-  std::vector<PMDParaProperties> getParaProperties() const override
+  std::shared_ptr<const PMDBitmapSource> getBitmap() const override
   {
-    return std::vector<PMDParaProperties>(1);
-  }
-
-  librevenge::RVNGBinaryData getBitmap() const override
-  {
-    librevenge::RVNGBinaryData temp;
-    return temp;
+    return std::shared_ptr<const PMDBitmapSource>();
   }
 
   ~PMDPolygon() override
@@ -296,13 +273,11 @@ class PMDTextBox : public PMDLineSet
   PMDShapePoint m_bboxTopLeft;
   PMDShapePoint m_bboxBotRight;
   PMDXForm m_xFormContainer;
-  std::string m_text;
-  std::vector<PMDCharProperties> m_charProps;
-  std::vector<PMDParaProperties> m_paraProps;
+  std::shared_ptr<const PMDStory> m_story;
 
 public:
-  PMDTextBox(const PMDShapePoint &bboxTopLeft, const PMDShapePoint &bboxBotRight, const PMDXForm &xFormContainer, const std::string text, const std::vector<PMDCharProperties> charProps, const std::vector<PMDParaProperties> paraProps)
-    : m_bboxTopLeft(bboxTopLeft), m_bboxBotRight(bboxBotRight),m_xFormContainer(xFormContainer), m_text(text), m_charProps(charProps), m_paraProps(paraProps)
+  PMDTextBox(const PMDShapePoint &bboxTopLeft, const PMDShapePoint &bboxBotRight, const PMDXForm &xFormContainer, const std::shared_ptr<const PMDStory> &story)
+    : m_bboxTopLeft(bboxTopLeft), m_bboxBotRight(bboxBotRight),m_xFormContainer(xFormContainer), m_story(story)
   { }
 
   double getRotation() const override
@@ -371,25 +346,14 @@ public:
     return PMDStrokeProperties();
   }
 
-  std::string getText() const override
-  {
-    return m_text;
-  }
-
-  std::vector<PMDCharProperties> getCharProperties() const override
-  {
-    return m_charProps;
-  }
-
-  std::vector<PMDParaProperties> getParaProperties() const override
+  std::shared_ptr<const PMDStory> getStory() const override
   {
-    return m_paraProps;
+    return m_story;
   }
 
-  librevenge::RVNGBinaryData getBitmap() const override
+  std::shared_ptr<const PMDBitmapSource> getBitmap() const override
   {
-    librevenge::RVNGBinaryData temp;
-    return temp;
+    return std::shared_ptr<const PMDBitmapSource>();
   }
 
   ~PMDTextBox() override
@@ -479,25 +443,14 @@ public:
     return m_strokeProps;
   }
 
-  std::string getText() const override
+  std::shared_ptr<const PMDStory> getStory() const override
   {
-    return "";
+    return std::shared_ptr<const PMDStory>();
   }
 
-  std::vector<PMDCharProperties> getCharProperties() const override
+  std::shared_ptr<const PMDBitmapSource> getBitmap() const override
   {
-    return std::vector<PMDCharProperties>(1);
-  }
-
-  std::vector<PMDParaProperties> getParaProperties() const override
-  {
-    return std::vector<PMDParaProperties>(1);
-  }
-
-  librevenge::RVNGBinaryData getBitmap() const override
-  {
-    librevenge::RVNGBinaryData temp;
-    return temp;
+    return std::shared_ptr<const PMDBitmapSource>();
   }
 
   ~PMDRectangle() override
@@ -585,25 +538,14 @@ public:
     return m_strokeProps;
   }
 
-  std::string getText() const override
-  {
-    return "";
-  }
-
-  std::vector<PMDCharProperties> getCharProperties() const override
+  std::shared_ptr<const PMDStory> getStory() const override
   {
-    return std::vector<PMDCharProperties>(1);
+    return std::shared_ptr<const PMDStory>();
   }
 
-  std::vector<PMDParaProperties> getParaProperties() const override
+  std::shared_ptr<const PMDBitmapSource> getBitmap() const override
   {
-    return std::vector<PMDParaProperties>(1);
-  }
-
-  librevenge::RVNGBinaryData getBitmap() const override
-  {
-    librevenge::RVNGBinaryData temp;
-    return temp;
+    return std::shared_ptr<const PMDBitmapSource>();
   }
 
   ~PMDEllipse() override
@@ -616,10 +558,10 @@ class PMDBitmap : public PMDLineSet
   PMDShapePoint m_bboxTopLeft;
   PMDShapePoint m_bboxBotRight;
   PMDXForm m_xFormContainer;
-  librevenge::RVNGBinaryData m_bitmap;
+  std::shared_ptr<const PMDBitmapSource> m_bitmap;
 
 public:
-  PMDBitmap(const PMDShapePoint &bboxTopLeft, const PMDShapePoint &bboxBotRight, const PMDXForm &xFormContainer, const librevenge::RVNGBinaryData &bitmap)
+  PMDBitmap(const PMDShapePoint &bboxTopLeft, const PMDShapePoint &bboxBotRight, const PMDXForm &xFormContainer, const std::shared_ptr<const PMDBitmapSource> &bitmap)
     : m_bboxTopLeft(bboxTopLeft), m_bboxBotRight(bboxBotRight), m_xFormContainer(xFormContainer),m_bitmap(bitmap)
   { }
 
@@ -692,22 +634,12 @@ public:
     return PMDStrokeProperties();
   }
 
-  std::string getText() const override
-  {
-    return "";
-  }
-
-  std::vector<PMDCharProperties> getCharProperties() const override
-  {
-    return std::vector<PMDCharProperties>(1);
-  }
-
-  std::vector<PMDParaProperties> getParaProperties() const override
+  std::shared_ptr<const PMDStory> getStory() const override
   {
-    return std::vector<PMDParaProperties>(1);
+    return std::shared_ptr<const PMDStory>();
   }
 
-  librevenge::RVNGBinaryData getBitmap() const override
+  std::shared_ptr<const PMDBitmapSource> getBitmap() const override
   {
     return m_bitmap;
   }
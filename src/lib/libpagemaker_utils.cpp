@@ -24,8 +24,6 @@ void checkStream(const RVNGInputStreamPtr &input)
     throw EndOfStreamException();
 }
 
-struct SeekFailedException : public PMDStreamException {};
-
 }
 
 #ifdef DEBUG
@@ -182,6 +180,26 @@ unsigned long getLength(const RVNGInputStreamPtr &input)
   return end;
 }
 
+std::vector<unsigned char> readAll(const RVNGInputStreamPtr &input)
+{
+  const unsigned long length = getLength(input);
+
+  std::vector<unsigned char> data;
+  data.reserve(length);
+
+  seek(input, 0);
+  while (data.size() < length && !input->isEnd())
+  {
+    unsigned long numBytesRead = 0;
+    const unsigned char *const p = input->read(length - data.size(), numBytesRead);
+    if (!p || numBytesRead == 0)
+      break;
+    data.insert(data.end(), p, p + numBytesRead);
+  }
+
+  return data;
+}
+
 EndOfStreamException::EndOfStreamException()
 {
 }
@@ -16,6 +16,7 @@
 
 #include <cmath>
 #include <cstdio>
+#include <vector>
 
 #include <boost/cstdint.hpp>
 
@@ -87,6 +88,9 @@ void seekRelative(const RVNGInputStreamPtr &input, long pos);
 
 unsigned long getLength(const RVNGInputStreamPtr &input);
 
+/** Read the whole content of the stream into memory. */
+std::vector<unsigned char> readAll(const RVNGInputStreamPtr &input);
+
 struct PMDStreamException
 {
   virtual ~PMDStreamException() { }
@@ -97,6 +101,10 @@ struct EndOfStreamException : public PMDStreamException
   EndOfStreamException();
 };
 
+struct SeekFailedException : public PMDStreamException
+{
+};
+
 struct GenericException
 {
 };